@@ -0,0 +1,90 @@
+//File: TrajectoryIndex.cpp
+//Brief: Family tree of an event's TG4Trajectories in flat arrays.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//Include header
+#include "alg/TrajectoryIndex.h"
+
+//edepsim includes
+#include "TG4Trajectory.h"
+
+namespace
+{
+  int ParentOf(const TG4Trajectory& traj)
+  {
+    #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
+    return traj.GetParentId();
+    #else
+    return traj.ParentId;
+    #endif
+  }
+}
+
+namespace truth
+{
+  TrajectoryIndex::TrajectoryIndex(): fRequested(false), fOffsets(1, 0), fChildren(), fMatriarch(), fNext()
+  {
+  }
+
+  void TrajectoryIndex::Fill(const std::vector<TG4Trajectory>& trajs)
+  {
+    const int nTrajs = trajs.size();
+
+    //Count each TrackId's children, then turn the counts into offsets
+    fOffsets.assign(nTrajs+1, 0);
+    for(const auto& traj: trajs)
+    {
+      const int parent = ParentOf(traj);
+      if(parent >= 0 && parent < nTrajs) ++fOffsets[parent+1];
+    }
+    for(int id = 0; id < nTrajs; ++id) fOffsets[id+1] += fOffsets[id];
+
+    //Put each child in its parent's range.  Children stay in TrackId order.
+    fChildren.resize(fOffsets.back());
+    fNext.assign(fOffsets.begin(), fOffsets.end()-1);
+    for(int id = 0; id < nTrajs; ++id)
+    {
+      const int parent = ParentOf(trajs[id]);
+      if(parent >= 0 && parent < nTrajs) fChildren[fNext[parent]++] = id;
+    }
+
+    //Geant4 always gives a parent a smaller TrackId than its children, so each parent's Matriarch is ready by the time
+    //I get to its children.  Walk up the tree the slow way just in case that's ever not true.
+    fMatriarch.assign(nTrajs, -1);
+    for(int id = 0; id < nTrajs; ++id)
+    {
+      const int parent = ParentOf(trajs[id]);
+      if(parent < 0 || parent >= nTrajs) fMatriarch[id] = id;
+      else if(parent < id) fMatriarch[id] = fMatriarch[parent];
+      else
+      {
+        int ancestor = parent;
+        for(int depth = 0; depth < nTrajs && ParentOf(trajs[ancestor]) >= 0 && ParentOf(trajs[ancestor]) < nTrajs; ++depth) ancestor = ParentOf(trajs[ancestor]);
+        fMatriarch[id] = ancestor;
+      }
+    }
+  }
+
+  TrajectoryIndex::Range TrajectoryIndex::Children(const int trackId) const
+  {
+    return Range(fChildren.data() + fOffsets[trackId], fChildren.data() + fOffsets[trackId+1]);
+  }
+
+  void TrajectoryIndex::Descendants(const int parent, std::set<int>& ids) const
+  {
+    if(parent < 0 || parent >= (int)fMatriarch.size()) return;
+
+    //Reconstructors in the same Scheduler layer call this at the same time, so the stack can't be a member
+    std::vector<int> stack(1, parent);
+    while(!stack.empty())
+    {
+      const int id = stack.back();
+      stack.pop_back();
+      for(const int child: Children(id))
+      {
+        ids.insert(child);
+        stack.push_back(child);
+      }
+    }
+  }
+}
@@ -0,0 +1,76 @@
+//File: TrajectoryIndex.h
+//Brief: A TrajectoryIndex answers questions about the family tree of an event's TG4Trajectories without searching 
+//       the whole list of TG4Trajectories every time.  truth::Descendants() looks at every TG4Trajectory for every 
+//       descendant it finds, so it takes O(N_trajectories * N_descendants) time.  Neutron-induced showers with 
+//       thousands of TG4Trajectories made that quadratic behavior very noticeable.  
+//
+//       Fill() builds a list of each TG4Trajectory's children in compressed sparse row format and the FS ancestor 
+//       of every TG4Trajectory in a couple of linear passes.  The driver application fills one TrajectoryIndex per 
+//       event and shares it with every plugin that asked for it.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//c++ includes
+#include <vector>
+#include <set>
+#include <cstddef>
+
+#ifndef TRUTH_TRAJECTORYINDEX_H
+#define TRUTH_TRAJECTORYINDEX_H
+
+class TG4Trajectory;
+
+namespace truth
+{
+  class TrajectoryIndex
+  {
+    public:
+      //Read-only view of a contiguous range of TrackIds
+      class Range
+      {
+        public:
+          Range(const int* begin, const int* end): fBegin(begin), fEnd(end) {}
+
+          const int* begin() const { return fBegin; }
+          const int* end() const { return fEnd; }
+          size_t size() const { return fEnd - fBegin; }
+          bool empty() const { return fBegin == fEnd; }
+
+        private:
+          const int* fBegin;
+          const int* fEnd;
+      };
+
+      TrajectoryIndex();
+      virtual ~TrajectoryIndex() = default;
+
+      //Plugins call this through UseTruth() when they are created.  The driver application doesn't bother filling a 
+      //TrajectoryIndex that nobody asked for.
+      void Request() { fRequested = true; }
+      bool Requested() const { return fRequested; }
+
+      //Index the TG4Trajectories in trajs.  Like everything else that reads edepsim files, assumes that each 
+      //TG4Trajectory's TrackId is its position in trajs.  Keeps memory around between events.
+      void Fill(const std::vector<TG4Trajectory>& trajs);
+
+      //TrackIds of the TG4Trajectories that trackId created directly
+      Range Children(const int trackId) const;
+
+      //TrackId of the FS particle that trackId came from.  FS particles are their own Matriarch.  O(1).  
+      int Matriarch(const int trackId) const { return fMatriarch[trackId]; }
+
+      //Insert the TrackIds of every TG4Trajectory descended from parent into ids.  Same result as truth::Descendants().
+      //Safe to call from several plugins at the same time.
+      void Descendants(const int parent, std::set<int>& ids) const;
+
+      size_t size() const { return fMatriarch.size(); }
+
+    private:
+      bool fRequested; //Has any plugin asked for this TrajectoryIndex?
+      std::vector<int> fOffsets; //Children of TrackId i are in fChildren[fOffsets[i], fOffsets[i+1])
+      std::vector<int> fChildren; //Every TrackId that has a parent grouped by parent
+      std::vector<int> fMatriarch; //FS ancestor of each TrackId
+      std::vector<int> fNext; //Scratch space for Fill(): where the next child of each TrackId goes in fChildren
+  };
+}
+
+#endif //TRUTH_TRAJECTORYINDEX_H
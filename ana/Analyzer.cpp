@@ -6,9 +6,12 @@
 
 //local includes
 #include "ana/Analyzer.h"
+#include "reco/alg/SegmentTable.h"
+
+//truth includes
+#include "alg/TrajectoryIndex.h"
 
 //ROOT includes
-#include "TTreeReader.h"
 #include "TGeoManager.h"
 
 //util includes
@@ -16,10 +19,24 @@
 
 namespace plgn
 {
-  Analyzer::Analyzer(const Config& config): fEvent(*(config.Reader), "Event"), fGeo(nullptr)
+  Analyzer::Analyzer(const Config& config): fEvent(*(config.CurrentEvent)), fGeo(nullptr), fProducts(*(config.Registry)), fSegmentTable(*(config.Segments)), fTrajIndex(*(config.Truth)), fInputs()
   { 
   }
 
+  const reco::SegmentTable& Analyzer::UseSegments()
+  {
+    DeclareInput("SegmentDetectors");
+    fSegmentTable.Request();
+    return fSegmentTable;
+  }
+
+  const truth::TrajectoryIndex& Analyzer::UseTruth()
+  {
+    DeclareInput("Trajectories");
+    fTrajIndex.Request();
+    return fTrajIndex;
+  }
+
   void Analyzer::Analyze()
   {
     fGeo = gGeoManager; //TODO: Get TGeoManager from the current file instead?  
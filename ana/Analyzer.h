@@ -4,16 +4,17 @@
 //       derived classes, but derived classes must get their own access to other objects they want to use.
 //Author: Andrew Olivier aolivier@ur.rochester.edu
 
-//edepsim includes
-#include "TG4Event.h"
+//app includes
+#include "app/Event.h"
+#include "app/Products.h"
 
 //yaml-cpp includes
 #include "yaml-cpp/yaml.h"
 
-//ROOT includes
-#include "TTreeReaderValue.h"
+//c++ includes
+#include <vector>
+#include <string>
 
-class TTreeReader;
 class TGeoManager;
 class TTree;
 
@@ -22,6 +23,16 @@ namespace util
   class TFileSentry;
 }
 
+namespace reco
+{
+  class SegmentTable;
+}
+
+namespace truth
+{
+  class TrajectoryIndex;
+}
+
 namespace plgn
 {
   class Analyzer
@@ -30,7 +41,10 @@ namespace plgn
       struct Config //TODO: Provide a constructor so that I can hold reference members?
       {
         util::TFileSentry* File;
-        TTreeReader* Reader;
+        const Event* CurrentEvent; //The TG4Event the driver application reads each entry into
+        Products* Registry; //Where to find Reconstructors' products
+        reco::SegmentTable* Segments; //Every TG4HitSegment in the current event in the fiducial volume's coordinate system
+        truth::TrajectoryIndex* Truth; //Family tree of the current event's TG4Trajectories
         YAML::Node Options;
       };
 
@@ -39,10 +53,39 @@ namespace plgn
 
       void Analyze(); //Public interface to private implementation
 
+      //Names of the branches this Analyzer reads.  The parts of the TG4Event it needs are named Primaries, Trajectories, 
+      //and SegmentDetectors.  RunId and EventId are always available.  The driver application doesn't read anything else.
+      const std::vector<std::string>& Inputs() const { return fInputs; }
+
     protected:
       virtual void DoAnalyze() = 0; //Do plotting or other analysis tasks
 
-      TTreeReaderValue<TG4Event> fEvent;
+      //Derived classes should call this in their constructors to tell the driver application what they need.
+      void DeclareInput(const std::string& branch) { fInputs.push_back(branch); }
+
+      //Read a Reconstructor's products.  If no Reconstructor in this job makes branch, it is read from the input file.
+      template <class T>
+      Handle<T> Consume(const std::string& branch)
+      {
+        DeclareInput(branch);
+        return fProducts.Consume<T>(branch);
+      }
+
+      //Ask the driver application to fill a SegmentTable for every event and get read-only access to it.  Call this 
+      //in a derived class's constructor.  Also declares SegmentDetectors as an input.
+      const reco::SegmentTable& UseSegments();
+
+      //Ask the driver application to index the current event's TG4Trajectories by parent and get read-only access to 
+      //that index.  Call this in a derived class's constructor.  Also declares Trajectories as an input.
+      const truth::TrajectoryIndex& UseTruth();
+
+      const Event& fEvent;
       TGeoManager* fGeo;
+
+    private:
+      Products& fProducts; //Where Consume()d branches come from
+      reco::SegmentTable& fSegmentTable; //Filled by the driver application once per event if any plugin UseSegments()
+      truth::TrajectoryIndex& fTrajIndex; //Filled by the driver application once per event if any plugin UseTruth()
+      std::vector<std::string> fInputs; //Branches I read
   };
 }
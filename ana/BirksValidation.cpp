@@ -25,6 +25,9 @@ namespace ana
 {
   BirksValidation::BirksValidation(const plgn::Analyzer::Config& config): plgn::Analyzer(config), fEMin(config.Options["EMin"].as<double>())
   {
+    DeclareInput("SegmentDetectors");
+    DeclareInput("Trajectories");
+
     fVisFracVersusdEdx = config.File->make<TH2D>("VisFracVsdEdx", "Visible Fraction of Energy versus #frac{dE}{dx};#frac{dE}{dx};Fraction Visible;"
                                                                   "Hit Segments", 1000, 0., 300, 1000, 0, 1);
     fBirksResidual = config.File->make<TH1D>("BirksResidual", "Fractional Difference Between Visible Energy and Direct Birks' Law;"
@@ -45,10 +48,10 @@ namespace ana
 
   void BirksValidation::DoAnalyze()
   {
-    const auto& parts = fEvent->Trajectories;
+    const auto& parts = fEvent.Trajectories();
 
     //TODO: Make these plots per detector?
-    for(const auto& det: fEvent->SegmentDetectors)
+    for(const auto& det: fEvent.SegmentDetectors())
     {
       for(const auto& seg: det.second)
       { 
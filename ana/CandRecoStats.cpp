@@ -5,7 +5,6 @@
 //EDepNeutrons includes
 #include "ana/CandRecoStats.h"
 #include "app/Factory.cpp"
-#include "alg/TruthFunc.h"
 
 //util includes
 #include "ROOT/Base/TFileSentry.h"
@@ -27,10 +26,11 @@
 namespace ana
 {
   CandRecoStats::CandRecoStats(const plgn::Analyzer::Config& config): plgn::Analyzer(config), 
-                                                                      fCands(*(config.Reader), 
-                                                                             config.Options["--cand-alg"].as<std::string>().c_str()), 
-                                                                      fMinEnergy(config.Options["EMin"].as<double>())
+                                                                      fCands(Consume<pers::NeutronCand>(config.Options["--cand-alg"].as<std::string>())), 
+                                                                      fMinEnergy(config.Options["EMin"].as<double>()), fTruth(UseTruth())
   {
+    DeclareInput("Primaries");
+
     fCandidateEnergy = config.File->make<TH1D>("CandidateEnergy", "Energy Specturm of Neutron Candidates;Energy [MeV];Events",
                                                150, 0, 150);
     fCandPerNeutron = config.File->make<TH1D>("CandPerNeutron", "Number of Candidates per FS Neutron;Neutron Candidates;Neutrons",
@@ -74,9 +74,9 @@ namespace ana
   void CandRecoStats::DoAnalyze()
   {
     std::map<int, int> TrackIDsToFS; //Map from TrackIDs to FS neutron
-    const auto trajs = fEvent->Trajectories;
+    const auto trajs = fEvent.Trajectories();
 
-    for(const auto& vertex: fEvent->Primaries)
+    for(const auto& vertex: fEvent.Primaries())
     {
       for(const auto& part: vertex.Particles)
       {
@@ -93,7 +93,7 @@ namespace ana
         if(pdg == 2112 && KE > fMinEnergy)
         {
           std::set<int> descend;
-          truth::Descendants(trackId, trajs, descend); //Fill descend with the TrackIDs of part's descendants
+          fTruth.Descendants(trackId, descend); //Fill descend with the TrackIDs of part's descendants
           descend.insert(trackId);
           for(const auto& id: descend) TrackIDsToFS[id] = trackId; 
         }
@@ -134,7 +134,7 @@ namespace ana
         }
       }*/
 
-      if(FSIds.size() > 1) std::cout << "Got " << FSIds.size() << " true neutrons for one candidate in event " << fEvent->EventId << "\n";
+      if(FSIds.size() > 1) std::cout << "Got " << FSIds.size() << " true neutrons for one candidate in event " << fEvent.EventId() << "\n";
 
       double sumCauseE = 0.; //Sum of energy from all causes of this candidate      
       for(const int neutronID: FSIds) //For each FS neutron TrackID
@@ -219,7 +219,7 @@ namespace ana
                                                                                  });
       fDistFromVtx->Fill((closest->Start-FSPos).Vect().Mag());
       fCandPerNeutron->Fill(FS.second.size());
-      if(FS.second.size() > 5) std::cout << "Many-candidate event (" << FS.second.size() << " candidates): " << fEvent->EventId << "\n";
+      if(FS.second.size() > 5) std::cout << "Many-candidate event (" << FS.second.size() << " candidates): " << fEvent.EventId() << "\n";
       fCandPerNeutronVsNeutronKE->Fill(FSKE, FS.second.size());
     }
   }
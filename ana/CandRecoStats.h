@@ -6,11 +6,13 @@
 #include "TH1D.h"
 #include "TH1I.h"
 #include "TH2D.h"
-#include "TTreeReaderArray.h"
 
 //EDepNeutrons includes
 #include "ana/Analyzer.h"
 
+//truth includes
+#include "alg/TrajectoryIndex.h"
+
 //persistency includes
 #include "persistency/NeutronCand.h"
 
@@ -28,7 +30,7 @@ namespace ana
     protected:
       virtual void DoAnalyze() override;
 
-      TTreeReaderArray<pers::NeutronCand> fCands; //The source of NeutronCands to analyze
+      plgn::Handle<pers::NeutronCand> fCands; //The source of NeutronCands to analyze
 
       const double fMinEnergy; //Energy cut used for FS neutrons
 
@@ -48,6 +50,8 @@ namespace ana
       TH2D* fERecoVsTrue; //Total reconstructed neutron energy versus total true neutron energy
       //TH1D* fLostNeutronE; //When multiple neutrons are grouped into one candidate, what are the energies of the neutrons that 
                            //are not the most energetic?
+
+      const truth::TrajectoryIndex& fTruth; //Which TG4Trajectories came from which.  Shared with other plugins.
   };
 }
 
@@ -5,7 +5,6 @@
 //EDepNeutrons includes
 #include "ana/CandTOF.h"
 #include "app/Factory.cpp"
-#include "alg/TruthFunc.h"
 
 //util includes
 #include "ROOT/Base/TFileSentry.h"
@@ -27,14 +26,14 @@
 
 namespace ana
 {
-  CandTOF::CandTOF(const plgn::Analyzer::Config& config): plgn::Analyzer(config), fCands(*(config.Reader), 
-                                                                                  config.Options["CandAlg"].as<std::string>().c_str()), 
-                                                                fClusters(*(config.Reader), 
-                                                                          config.Options["ClusterAlg"].as<std::string>().c_str()),
+  CandTOF::CandTOF(const plgn::Analyzer::Config& config): plgn::Analyzer(config), fCands(Consume<pers::NeutronCand>(config.Options["CandAlg"].as<std::string>())), 
+                                                                fClusters(Consume<pers::MCCluster>(config.Options["ClusterAlg"].as<std::string>())),
                                                                 fGen(std::chrono::system_clock::now().time_since_epoch().count()), 
                                                                 fGaus(0., config.Options["TimeRes"].as<double>()), fPosRes(10.), 
-                                                                fTimeRes(config.Options["TimeRes"].as<double>())
+                                                                fTimeRes(config.Options["TimeRes"].as<double>()), fTruth(UseTruth())
   {
+    DeclareInput("Primaries");
+
     const float timeMax = 100., distMax = 5000.;
     const size_t nTimeBins = timeMax/config.Options["TimeRes"].as<double>(), nDistBins = distMax/10.0; //1.0cm bins
     fNeutronHitTime = config.File->make<TH1D>("NeutronHitTime", "Time of First Hit from a FS Neutron;Time [ns];Visible FS Neutrons", nTimeBins, 0, timeMax); 
@@ -64,9 +63,9 @@ namespace ana
   void CandTOF::DoAnalyze()
   {
     std::map<int, int> TrackIDsToFS; //Map from TrackIDs to FS neutron
-    const auto trajs = fEvent->Trajectories;
+    const auto trajs = fEvent.Trajectories();
 
-    for(const auto& vertex: fEvent->Primaries)
+    for(const auto& vertex: fEvent.Primaries())
     {
       for(const auto& part: vertex.Particles)
       {
@@ -81,15 +80,15 @@ namespace ana
         if(pdg == 2112) //&& part.Momentum.E() - part.Momentum.Mag() > fMinEnergy)
         {
           std::set<int> descend;
-          truth::Descendants(trackId, trajs, descend); //Fill descend with the TrackIDs of part's descendants
+          fTruth.Descendants(trackId, descend); //Fill descend with the TrackIDs of part's descendants
           descend.insert(trackId);
           for(const auto& id: descend) TrackIDsToFS[id] = trackId; 
         }
       }
     }
 
-    //for(const auto& vert: fEvent->Primaries)
-    const auto& vert = fEvent->Primaries.front(); //TODO: Associate NeutronCands with vertices?
+    //for(const auto& vert: fEvent.Primaries())
+    const auto& vert = fEvent.Primaries().front(); //TODO: Associate NeutronCands with vertices?
     {
       #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
       const auto& vertPos = vert.GetPosition();
@@ -189,7 +188,7 @@ namespace ana
                         << "closest->Position is (" << cand.Start.X() << ", " << cand.Start.Y() << ", " 
                         << cand.Start.Z() << ")\n"
                         << "Vertex is (" << vertPos.X() << ", " << vertPos.Y() << ", " << vertPos.Z() << ")\n"
-                        << "EventID is " << fEvent->EventId << "\n";
+                        << "EventID is " << fEvent.EventId() << "\n";
             }
   
             //const auto uncert = beta*m/gamma/gamma/gamma/deltaT*std::sqrt(1.*1./c/c+0.7*0.7*beta*beta);
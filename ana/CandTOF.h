@@ -6,11 +6,13 @@
 #include "TH1D.h"
 #include "TH1I.h"
 #include "TH2D.h"
-#include "TTreeReaderArray.h"
 
 //EDepNeutrons includes
 #include "ana/Analyzer.h"
 
+//truth includes
+#include "alg/TrajectoryIndex.h"
+
 //persistency includes
 #include "persistency/NeutronCand.h"
 #include "persistency/MCCluster.h"
@@ -32,8 +34,8 @@ namespace ana
     protected:
       virtual void DoAnalyze() override;
 
-      TTreeReaderArray<pers::NeutronCand> fCands; //The source of NeutronCands to be analyzed
-      TTreeReaderArray<pers::MCCluster> fClusters; //The source of MCClusters referred to by NeutronCands
+      plgn::Handle<pers::NeutronCand> fCands; //The source of NeutronCands to be analyzed
+      plgn::Handle<pers::MCCluster> fClusters; //The source of MCClusters referred to by NeutronCands
 
       TH1D* fNeutronHitTime; //Time of first hit caused by each ancestor of a FS neutron in ns
       TH2D* fNeutronTimeVersusDist; //Times of first hit caused by each ancestor of a FS neutron versus its' distance from interaction vertex.  
@@ -56,6 +58,8 @@ namespace ana
       //Configuration parameters I want to keep around for statistics
       double fPosRes; //Position resolution for MCHits
       double fTimeRes; //Time resolution for MCHits
+
+      const truth::TrajectoryIndex& fTruth; //Which TG4Trajectories came from which.  Shared with other plugins.
   };
 }
 
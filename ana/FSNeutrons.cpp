@@ -23,6 +23,8 @@ namespace ana
 {
   FSNeutrons::FSNeutrons(const plgn::Analyzer::Config& config): plgn::Analyzer(config), fEMin(config.Options["EMin"].as<double>())
   {
+    DeclareInput("Primaries"); //Truth only, so hit segments never get read for this plugin
+
     fNeutronEnergy = config.File->make<TH1D>("FSNeutronEnergy", "KE of All FS Neutrons;Energy [MeV];FS Neutrons", 200, 0, 3000);
     fNFSNeutrons = config.File->make<TH1D>("NFSNeutrons", ("Number of FS Neutrons Above "+std::to_string(fEMin)+" MeV;FS Neutrons;Events").c_str(), 
                                            10, 0, 10);
@@ -31,7 +33,7 @@ namespace ana
   void FSNeutrons::DoAnalyze()
   {  
     size_t nFSNeutrons = 0;
-    for(const auto& vertex: fEvent->Primaries)
+    for(const auto& vertex: fEvent.Primaries())
     {
       for(const auto& part: vertex.Particles)
       {
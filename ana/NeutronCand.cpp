@@ -5,7 +5,6 @@
 //EDepNeutrons includes
 #include "ana/NeutronCand.h"
 #include "app/Factory.cpp"
-#include "alg/TruthFunc.h"
 
 //util includes
 #include "ROOT/Base/TFileSentry.h"
@@ -27,12 +26,13 @@
 namespace ana
 {
   NeutronCand::NeutronCand(const plgn::Analyzer::Config& config): plgn::Analyzer(config), 
-                                                                  fClusters(*(config.Reader), 
-                                                                            config.Options["ClusterAlg"].as<std::string>().c_str()), 
+                                                                  fClusters(Consume<pers::MCCluster>(config.Options["ClusterAlg"].as<std::string>())), 
                                                                   fMinEnergy(config.Options["EMin"].as<double>()), fClusterNumber(-314), 
                                                                   fClustersFromEnd(-314), fDeltaAngle(-314), fEDep(-314), fELeft(-314), 
-                                                                  fEFromTOF(-314), fDistFromPrev(-314), fDeltaT(-314), fTrueE(-314)
+                                                                  fEFromTOF(-314), fDistFromPrev(-314), fDeltaT(-314), fTrueE(-314), fTruth(UseTruth())
   {
+    DeclareInput("Primaries");
+
     fCandidateEnergy = config.File->make<TH1D>("CandidateEnergy", "Energy Specturm of Neutron Candidates;Energy [MeV];Events",
                                                150, 0, 150);
     fCandPerNeutron = config.File->make<TH1D>("CandPerNeutron", "Number of Candidates per FS Neutron;Neutron Candidates;Neutrons",
@@ -88,9 +88,9 @@ namespace ana
     fTrueE = -314;
 
     std::map<int, int> TrackIDsToFS; //Map from TrackIDs to FS neutron
-    const auto trajs = fEvent->Trajectories;
+    const auto trajs = fEvent.Trajectories();
 
-    for(const auto& vertex: fEvent->Primaries)
+    for(const auto& vertex: fEvent.Primaries())
     {
       for(const auto& part: vertex.Particles)
       {
@@ -107,7 +107,7 @@ namespace ana
         if(pdg == 2112 && KE > fMinEnergy)
         {
           std::set<int> descend;
-          truth::Descendants(trackId, trajs, descend); //Fill descend with the TrackIDs of part's descendants
+          fTruth.Descendants(trackId, descend); //Fill descend with the TrackIDs of part's descendants
           descend.insert(trackId);
           for(const auto& id: descend) TrackIDsToFS[id] = trackId; 
         }
@@ -227,7 +227,7 @@ namespace ana
                                                                                  });
       fDistFromVtx->Fill((closest->Position-FSPos).Vect().Mag());
       fCandPerNeutron->Fill(FS.second.size());
-      if(FS.second.size() > 5) std::cout << "Many-candidate event (" << FS.second.size() << " candidates): " << fEvent->EventId << "\n";
+      if(FS.second.size() > 5) std::cout << "Many-candidate event (" << FS.second.size() << " candidates): " << fEvent.EventId() << "\n";
       
       #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
       fCandPerNeutronVsNeutronKE->Fill(trajs[FS.first].GetInitialMomentum().E()-trajs[FS.first].GetInitialMomentum().Mag(), FS.second.size());
@@ -6,11 +6,13 @@
 #include "TH1D.h"
 #include "TH1I.h"
 #include "TH2D.h"
-#include "TTreeReaderArray.h"
 
 //EDepNeutrons includes
 #include "ana/Analyzer.h"
 
+//truth includes
+#include "alg/TrajectoryIndex.h"
+
 //persistency includes
 #include "persistency/MCCluster.h"
 
@@ -28,7 +30,7 @@ namespace ana
     protected:
       virtual void DoAnalyze() override;
 
-      TTreeReaderArray<pers::MCCluster> fClusters; //The source of MCClusters to be analyzed
+      plgn::Handle<pers::MCCluster> fClusters; //The source of MCClusters to be analyzed
 
       const double fMinEnergy; //Energy cut used for FS neutrons
 
@@ -59,6 +61,8 @@ namespace ana
       float fDistFromPrev; //Distance between this cluster and the next cluster
       float fDeltaT; //Time difference between clusters
       float fTrueE; //True energy of the neutron that produced a cluster
+
+      const truth::TrajectoryIndex& fTruth; //Which TG4Trajectories came from which.  Shared with other plugins.
   };
 }
 
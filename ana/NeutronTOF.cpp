@@ -5,7 +5,6 @@
 //EDepNeutrons includes
 #include "ana/NeutronTOF.h"
 #include "app/Factory.cpp"
-#include "alg/TruthFunc.h"
 
 //util includes
 #include "ROOT/Base/TFileSentry.h"
@@ -26,12 +25,13 @@
 
 namespace ana
 {
-  NeutronTOF::NeutronTOF(const plgn::Analyzer::Config& config): plgn::Analyzer(config), fHits(*(config.Reader), 
-                                                                                              config.Options["HitAlg"].as<std::string>().c_str()), 
+  NeutronTOF::NeutronTOF(const plgn::Analyzer::Config& config): plgn::Analyzer(config), fHits(Consume<pers::MCHit>(config.Options["HitAlg"].as<std::string>())), 
                                                                 fGen(std::chrono::system_clock::now().time_since_epoch().count()), 
                                                                 fGaus(0., config.Options["TimeRes"].as<double>()), fPosRes(10.), 
-                                                                fTimeRes(config.Options["TimeRes"].as<double>())
+                                                                fTimeRes(config.Options["TimeRes"].as<double>()), fTruth(UseTruth())
   {
+    DeclareInput("Primaries");
+
     const float timeMax = 100., distMax = 5000.;
     const size_t nTimeBins = timeMax/config.Options["TimeRes"].as<double>(), nDistBins = distMax/10.0; //1.0cm bins
     fNeutronHitTime = config.File->make<TH1D>("NeutronHitTime", "Time of First Hit from a FS Neutron;Time [ns];Visible FS Neutrons", nTimeBins, 0, timeMax); 
@@ -56,9 +56,8 @@ namespace ana
   void NeutronTOF::DoAnalyze()
   {
     std::map<int, int> TrackIDsToFS; //Map from TrackIDs to FS neutron
-    const auto trajs = fEvent->Trajectories;
 
-    for(const auto& vertex: fEvent->Primaries)
+    for(const auto& vertex: fEvent.Primaries())
     {
       for(const auto& part: vertex.Particles)
       {
@@ -73,14 +72,14 @@ namespace ana
         if(pdg == 2112) //&& part.Momentum.E() - part.Momentum.Mag() > fMinEnergy)
         {
           std::set<int> descend;
-          truth::Descendants(trackId, trajs, descend); //Fill descend with the TrackIDs of part's descendants
+          fTruth.Descendants(trackId, descend); //Fill descend with the TrackIDs of part's descendants
           descend.insert(trackId);
           for(const auto& id: descend) TrackIDsToFS[id] = trackId; 
         }
       }
     }
 
-    for(const auto& vert: fEvent->Primaries)
+    for(const auto& vert: fEvent.Primaries())
     {
       #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
       auto vertPos = vert.GetPosition();
@@ -177,7 +176,7 @@ namespace ana
                           << "closest->Position is (" << (*closest).Position.X() << ", " << (*closest).Position.Y() << ", " 
                           << (*closest).Position.Z() << ")\n"
                           << "Vertex is (" << vertPos.X() << ", " << vertPos.Y() << ", " << vertPos.Z() << ")\n"
-                          << "EventID is " << fEvent->EventId << "\n";
+                          << "EventID is " << fEvent.EventId() << "\n";
               }
 
               //const auto uncert = beta*m/gamma/gamma/gamma/deltaT*std::sqrt(1.*1./c/c+0.7*0.7*beta*beta);
@@ -6,11 +6,13 @@
 #include "TH1D.h"
 #include "TH1I.h"
 #include "TH2D.h"
-#include "TTreeReaderArray.h"
 
 //EDepNeutrons includes
 #include "ana/Analyzer.h"
 
+//truth includes
+#include "alg/TrajectoryIndex.h"
+
 //persistency includes
 #include "persistency/MCHit.h"
 
@@ -31,7 +33,7 @@ namespace ana
     protected:
       virtual void DoAnalyze() override;
 
-      TTreeReaderArray<pers::MCHit> fHits; //The source of MCHits to be analyzed
+      plgn::Handle<pers::MCHit> fHits; //The source of MCHits to be analyzed
 
       TH1D* fNeutronHitTime; //Time of first hit caused by each ancestor of a FS neutron in ns
       TH2D* fNeutronTimeVersusDist; //Times of first hit caused by each ancestor of a FS neutron versus its' distance from interaction vertex.  
@@ -51,6 +53,8 @@ namespace ana
       //Configuration parameters I want to keep around for statistics
       double fPosRes; //Position resolution for MCHits
       double fTimeRes; //Time resolution for MCHits
+
+      const truth::TrajectoryIndex& fTruth; //Which TG4Trajectories came from which.  Shared with other plugins.
   };
 }
 
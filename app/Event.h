@@ -0,0 +1,100 @@
+//File: Event.h
+//Brief: An Event owns the TG4Event that the driver application reads each entry into.  Plugins get read-only views of 
+//       its parts, like fEvent.Trajectories(), that never copy the std::vectors inside the TG4Event.  Writing 
+//       const auto trajs = fEvent->Trajectories used to copy every TG4Trajectory in the event, so plugins can't get at 
+//       the TG4Event itself anymore.  The driver points both the input TTree and the output TTree at the same TG4Event, 
+//       so an entry is only ever deserialized once even if it gets written out again.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//app includes
+#include "app/Span.h"
+
+//edepsim includes
+#include "TG4Event.h"
+
+//c++ includes
+#include <string>
+#include <utility>
+
+#ifndef PLGN_EVENT_H
+#define PLGN_EVENT_H
+
+namespace app
+{
+  class Worker;
+}
+
+namespace plgn
+{
+  //Read-only view of the TG4HitSegments in each sensitive detector.  Iterating over it gives std::pairs of each
+  //detector's name and a Span of its TG4HitSegments, so loops like for(const auto& det: fEvent.SegmentDetectors())
+  //still work with det.first and det.second.
+  class DetectorView
+  {
+    public:
+      using value_type = std::pair<const std::string&, Span<TG4HitSegment>>;
+
+      class const_iterator
+      {
+        public:
+          const_iterator(TG4HitSegmentDetectors::const_iterator pos): fPos(pos) {}
+
+          value_type operator *() const { return value_type(fPos->first, Span<TG4HitSegment>(fPos->second)); }
+          const_iterator& operator ++() { ++fPos; return *this; }
+          bool operator ==(const const_iterator& other) const { return fPos == other.fPos; }
+          bool operator !=(const const_iterator& other) const { return fPos != other.fPos; }
+
+        private:
+          TG4HitSegmentDetectors::const_iterator fPos;
+      };
+
+      DetectorView(const TG4HitSegmentDetectors& dets): fDets(&dets) {}
+
+      const_iterator begin() const { return const_iterator(fDets->begin()); }
+      const_iterator end() const { return const_iterator(fDets->end()); }
+      size_t size() const { return fDets->size(); }
+      bool empty() const { return fDets->empty(); }
+
+      //TG4HitSegments in the sensitive detector called name.  Empty if there's no such detector in this event.
+      Span<TG4HitSegment> operator [](const std::string& name) const
+      {
+        const auto found = fDets->find(name);
+        if(found == fDets->end()) return Span<TG4HitSegment>();
+        return Span<TG4HitSegment>(found->second);
+      }
+
+    private:
+      const TG4HitSegmentDetectors* fDets; //Observer pointer
+  };
+
+  class Event
+  {
+    public:
+      Event(): fEvent(new TG4Event()) {}
+      ~Event() { delete fEvent; }
+
+      //Plugins hold references to an Event, so it should never move.
+      Event(const Event&) = delete;
+      Event& operator =(const Event&) = delete;
+
+      //Read-only access for plugins.  None of these copy anything but a pointer or two.
+      int RunId() const { return fEvent->RunId; }
+      int EventId() const { return fEvent->EventId; }
+      Span<TG4PrimaryVertex> Primaries() const { return Span<TG4PrimaryVertex>(fEvent->Primaries); }
+      Span<TG4Trajectory> Trajectories() const { return Span<TG4Trajectory>(fEvent->Trajectories); }
+      DetectorView SegmentDetectors() const { return DetectorView(fEvent->SegmentDetectors); }
+
+    private:
+      friend class app::Worker; //Only the driver application sees the whole TG4Event
+
+      const TG4Event* operator ->() const { return fEvent; }
+      const TG4Event& operator *() const { return *fEvent; }
+
+      //For the driver application to pass to TTree::SetBranchAddress().  ROOT might replace the TG4Event this points to.
+      TG4Event** Address() { return &fEvent; }
+
+      TG4Event* fEvent; //Owned by this Event
+  };
+}
+
+#endif //PLGN_EVENT_H
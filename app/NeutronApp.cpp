@@ -7,15 +7,18 @@
 //       Analysis plugins are given read-only access to the read in TTree after the reconstruction plugins have processed it.  
 //       Since the output tree is a clone of the input tree, analysis plugins will see any changes the reconstruction plugins 
 //       made.   
+//
+//       Entries can be processed by more than one thread at a time.  Each thread gets its own app::Worker with its own 
+//       copy of every plugin, and entries are written to the output TTree in the same order they were read.  
 //Author: Andrew Olivier aolivier@ur.rochester.edu
 
 //edepsim includes
 #include "TG4Event.h"
 
 //Plugin includes
-#include "app/Factory.cpp"
-#include "ana/Analyzer.h"
-#include "reco/Reconstructor.h"
+#include "app/Worker.h"
+//persistency includes
+#include "persistency/AlgNames.h"
 
 //util includes
 #include "IO/File/RegexFiles.cxx"
@@ -35,13 +38,21 @@
 
 //ROOT includes
 #include "TChain.h"
-#include "TTreeReader.h" 
-#include "TTreeReaderValue.h"
 #include "TFile.h"
+#include "TMemFile.h"
+#include "TFileMerger.h"
+#include "TROOT.h" //For ROOT::EnableThreadSafety()
 #include "TGeoManager.h" //For gGeoManager
 
 //c++ includes
 #include <iostream>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <algorithm>
 
 int main(int argc, const char** argv)
 {
@@ -114,6 +125,10 @@ int main(int argc, const char** argv)
 
     //Look for options for the application first
     long int nEvents = -1; //placeholder value
+    std::vector<std::string> friendFiles; //RecoEvents files from earlier jobs to attach to inFiles
+    size_t nThreads = 1; //Number of Workers processing entries at the same time
+    size_t nTasks = 1; //Number of Reconstructors each Worker can run at the same time
+    Long64_t chunkSize = 100; //Number of entries a Worker processes before it commits them to the output TTree
     if(config["app"])
     {
       const auto& appOpt = config["app"];
@@ -125,7 +140,14 @@ int main(int argc, const char** argv)
         //TODO: Support for regular expressions via RegexFiles?
 
         if(source["NEvents"]) nEvents = source["NEvents"].as<long int>();
+
+        const auto& friends = source["friends"];
+        if(friends) for(auto name = friends.begin(); name != friends.end(); ++name) friendFiles.push_back(name->as<std::string>());
       }
+
+      if(appOpt["threads"]) nThreads = appOpt["threads"].as<size_t>();
+      if(appOpt["chunk"]) chunkSize = appOpt["chunk"].as<Long64_t>();
+      if(appOpt["tasks"]) nTasks = appOpt["tasks"].as<size_t>();
     }
 
     //Validate configuration so far and prepare to read files
@@ -135,6 +157,34 @@ int main(int argc, const char** argv)
       return 6;
     }
 
+    if(friendFiles.size() > 1 && friendFiles.size() != inFiles.size())
+    {
+      std::cerr << "Got " << friendFiles.size() << " friend files for " << inFiles.size() << " input files.  There must be either one friend "
+                << "file for every input file or one friend file for each input file, in the same order.\n";
+      return 6;
+    }
+    if(friendFiles.size() == 1) friendFiles.resize(inFiles.size(), friendFiles.front());
+
+    //A friend-mode job writes the number of input files it read before each one to RecoEvents as File.  The same 
+    //friend file might be listed for more than one input file, so count which of its input files each one is.  This 
+    //only works if the input files are listed in the same order as in that job.  Workers check each entry's RunId and 
+    //EventId against RecoEvents, so a different list stops the job instead of mixing up events.
+    std::vector<Int_t> friendFileNumbers;
+    for(auto friendFile = friendFiles.begin(); friendFile != friendFiles.end(); ++friendFile)
+    {
+      friendFileNumbers.push_back(std::count(friendFiles.begin(), friendFile, *friendFile));
+    }
+
+    if(nThreads == 0 || chunkSize <= 0)
+    {
+      std::cerr << "Need at least 1 thread and a positive chunk size, but got " << nThreads << " threads with chunks of "
+                << chunkSize << " entries.\n";
+      return 9;
+    }
+
+    //ROOT needs to know about threads before any of them touch it.
+    if(nThreads > 1 || nTasks > 1) ROOT::EnableThreadSafety();
+
     //Set up to read files
     auto inFile = TFile::Open(inFiles.begin()->c_str(), "READ");
     if(!inFile)
@@ -150,80 +200,68 @@ int main(int argc, const char** argv)
       return 2;
     }
 
-    TTreeReader inReader(inTree);
-    TTreeReaderValue<TG4Event> event(inReader, "Event");
-
     TFile* outFile = nullptr;
     TTree* outTree = nullptr;
 
-    //Find all algorithms from the configuration document.  
-    std::vector<std::unique_ptr<plgn::Reconstructor>> recoAlgs;
-
     if(config["reco"])
     {
       //Only create an output file if there are Reconstructors being run
-      //Create a copy of the structure of the input tree
       outFile = TFile::Open(config["reco"]["OutputName"].as<std::string>().c_str(), "CREATE"); 
       if(!outFile)
       {
-        std::cerr << "Could not create a new file called " << outFile->GetName() << " to write out reconstructed events.\n";
+        std::cerr << "Could not create a new file called " << config["reco"]["OutputName"] << " to write out reconstructed events.\n";
         return 3;
       }
-
-      outTree = inTree->CloneTree(0);
-      outTree->SetDirectory(outFile);
-
-      plgn::Reconstructor::Config recoConfig;
-      recoConfig.Input = &inReader;
-      recoConfig.Output = outTree;
-
-      const auto& recos = config["reco"]["algs"];
-      auto& recoFactory = plgn::Factory<plgn::Reconstructor>::instance();
-      for(auto reco =  recos.begin(); reco != recos.end(); ++reco)
-      {
-        recoConfig.Options = reco->second;
-        auto recoAlg = recoFactory.Get(reco->first.as<std::string>(), recoConfig);
-        if(recoAlg)
-        {
-          recoAlgs.push_back(std::move(recoAlg));
-        }
-        else std::cerr << "Could not find Reconstructor algorithm " << reco->first << "\n";
-      }
     }
     else std::cout << "No Reconstructors specified, so not creating an output file.\n";
  
     //Parameters from the command line
     //const auto inFiles = util::RegexFilesPath<std::string>(options["--regex"], options["--path"]);
 
-    //Get analysis plugins
-    std::vector<std::pair<std::string, std::unique_ptr<plgn::Analyzer>>> anaAlgs;    
-
+    //Set up histogram files for analysis plugins.  With more than one thread, each Worker gets its own file in memory, and 
+    //those files are merged into the real histogram file at the end of the job.
     std::unique_ptr<util::TFileSentry> anaFile(nullptr); 
+    std::vector<std::shared_ptr<TFile>> workerAnaFiles;
+    std::vector<std::unique_ptr<util::TFileSentry>> workerAnaSentries;
     if(config["analysis"]) 
     { 
-      anaFile.reset(new util::TFileSentry(config["analysis"]["FileName"].as<std::string>().c_str())); 
       //Only create histogram file if I am running analysis plugins                                                              
-      util::SelectStyle(config["analysis"]["style"].as<std::string>()); 
-      plgn::Analyzer::Config anaConfig;
-      anaConfig.File = anaFile.get();
-      anaConfig.Reader = &inReader;
-      //anaConfig.Options = &options;
-  
-      const auto& anas = config["analysis"]["algs"];
-      auto& anaFactory = plgn::Factory<plgn::Analyzer>::instance();
-      for(auto ana = anas.begin(); ana != anas.end(); ++ana)
+      if(nThreads == 1) anaFile.reset(new util::TFileSentry(config["analysis"]["FileName"].as<std::string>().c_str())); 
+      else
       {
-        anaConfig.Options = ana->second;
-        anaFile->cd(ana->first.as<std::string>());
-        auto anaAlg = anaFactory.Get(ana->first.as<std::string>(), anaConfig);
-        if(anaAlg) anaAlgs.emplace_back(ana->first.as<std::string>(), std::move(anaAlg));
-        else std::cerr << "Could not find Analyzer algorithm " << ana->first << "\n";
+        for(size_t thread = 0; thread < nThreads; ++thread)
+        {
+          workerAnaFiles.emplace_back(new TMemFile(("Worker"+std::to_string(thread)+".root").c_str(), "RECREATE"));
+          workerAnaSentries.emplace_back(new util::TFileSentry(workerAnaFiles.back()));
+        }
       }
+      util::SelectStyle(config["analysis"]["style"].as<std::string>()); 
     }
     else std::cout << "No Analyzers specified, so not creating a histogram file.\n";
 
-    for(const auto& file: inFiles)
+    //Each Worker gets its own copy of every plugin.  With only one Worker, it writes directly to the output file.  
+    std::vector<std::unique_ptr<app::Worker>> workers;
+    for(size_t thread = 0; thread < nThreads; ++thread)
     {
+      workers.emplace_back(new app::Worker(config, inFiles.front(), friendFiles.empty()?"":friendFiles.front(), (nThreads == 1)?outFile:nullptr, 
+                                           (nThreads == 1)?anaFile.get():(workerAnaSentries.empty()?nullptr:workerAnaSentries[thread].get())));
+    }
+
+    std::cout << "Reconstructors will run in this order:\n";
+    workers.front()->PrintSchedule(std::cout);
+
+    outTree = workers.front()->Output();
+    if(nThreads > 1 && outTree) 
+    {
+      //Workers fill memory-resident stages that get copied into a TTree with the same structure in the output file.
+      outTree = outTree->CloneTree(0);
+      outTree->SetDirectory(outFile);
+    }
+
+    Int_t nFilesRead = 0; //Written to RecoEvents as File.  Skipped files don't count so that a later job can find the rest.
+    for(size_t whichFile = 0; whichFile < inFiles.size(); ++whichFile)
+    {
+      const auto& file = inFiles[whichFile];
       if(inFile) delete inFile; //Make sure previous file is closed.  
       inFile = TFile::Open(file.c_str(), "READ");
       if(!inFile) 
@@ -239,6 +277,7 @@ int main(int argc, const char** argv)
         continue;
       } 
 
+      //All Workers share the geometry, so load it before any of them start.  Plugins only read from gGeoManager.
       gGeoManager = (TGeoManager*)inFile->Get("EDepSimGeometry");
       if(!gGeoManager)
       {
@@ -246,54 +285,126 @@ int main(int argc, const char** argv)
         continue;
       }
 
-      if(outTree) inTree->CopyAddresses(outTree);
-      else std::cout << "There is no output tree, so not copying addresses.\n"; //TODO: This is only debugging output.  Remove it from release builds?
-      inReader.SetTree(inTree);
+      if(!outTree) std::cout << "There is no output tree, so not copying addresses.\n"; //TODO: This is only debugging output.  Remove it from release builds?
+      for(auto& worker: workers) 
+      {
+        if(friendFiles.empty()) worker->SetFile(file, nFilesRead);
+        else worker->SetFile(file, nFilesRead, friendFiles[whichFile], friendFileNumbers[whichFile]);
+      }
+      ++nFilesRead;
+
+      Long64_t nEntries = inTree->GetEntries();
+      if(nEvents >= 0 && nEvents < nEntries) nEntries = nEvents;
 
       std::cout << "Processing file " << file << "\n";
 
-      for(const auto entry: inReader)
+      if(nThreads == 1)
       {
-        if(entry == nEvents) break;
-
-        //First, call Reconstructor plugins
-        bool foundReco = false;
-        for(const auto& reco: recoAlgs)
-        {
-          foundReco = (reco->Reconstruct())?true:foundReco;
-        }
-
-        //If something was reconstructed, write to the output tree
-        if(foundReco) 
+        for(Long64_t entry = 0; entry < nEntries; ++entry)
         {
-          inTree->GetEntry(entry); //TODO: Why does this work when SetBranchStatus() doesn't?  mysteriesOfTheUniverse.push_back(this)
-          if(!outTree) std::cerr << "Did some reconstruction, but output TTree has not been created!\n"; //TODO: This is only debugging output.  Remove it from release builds?
-          outTree->Fill();
+          workers.front()->Process(entry, entry+1);
+          if(entry%100 == 0 || entry < 100) std::cout << "Finished processing event " << entry << "\n";
         }
-        //else std::cout << "No reconstruction objects to save for event " << entry << "\n";
+        continue;
+      }
 
-        //Next, call analysis plugins
-        for(const auto& ana: anaAlgs) 
+      //Workers take chunks of entries in whatever order they finish, but they commit them to outTree in order of 
+      //entry number.  A Worker that finishes early waits for its turn to commit before taking another chunk.
+      const Long64_t nChunks = (nEntries + chunkSize - 1)/chunkSize;
+      std::atomic<Long64_t> nextChunk(0);
+      Long64_t nextCommit = 0; //Guarded by commitMutex
+      bool failed = false; //Guarded by commitMutex
+      std::exception_ptr error; //Guarded by commitMutex
+      std::mutex commitMutex;
+      std::condition_variable commitTurn;
+
+      std::vector<std::thread> threads;
+      for(auto& worker: workers)
+      {
+        threads.emplace_back([&, worker = worker.get()]()
         {
-          //TODO: Change to directory for this analyzer in case make is called during Analyze.  This might be an indication that I need to rethink
-          //      TFileSentry.
-          anaFile->cd(ana.first);
-          ana.second->Analyze();
-        }
-
-        if(entry%100 == 0 || entry < 100) std::cout << "Finished processing event " << entry << "\n";
-
-        //TODO: Use gGeoManager in plugins for now, but consider retrieving TGeoManager from current file instead.  
+          try
+          {
+            for(Long64_t chunk = nextChunk++; chunk < nChunks; chunk = nextChunk++)
+            {
+              const Long64_t begin = chunk*chunkSize, end = std::min(begin + chunkSize, nEntries);
+              worker->Process(begin, end);
+
+              std::unique_lock<std::mutex> lock(commitMutex);
+              commitTurn.wait(lock, [&]() { return nextCommit == chunk || failed; });
+              if(failed) return;
+              if(outTree) worker->Commit(*outTree);
+              std::cout << "Finished processing events " << begin << " through " << end-1 << "\n";
+              ++nextCommit;
+              commitTurn.notify_all();
+            }
+          }
+          catch(...) //Let the main thread report this exception.  util::exception doesn't derive from std::exception.
+          {
+            std::lock_guard<std::mutex> lock(commitMutex);
+            if(!failed) error = std::current_exception();
+            failed = true;
+            commitTurn.notify_all();
+          }
+        });
       }
+      for(auto& thread: threads) thread.join();
+      if(error) std::rethrow_exception(error);
     }
    
+    //Report how much of the input files had to be read for each entry
+    app::Worker::IOStats stats{0, 0, 0, 0};
+    for(const auto& worker: workers) stats += worker->Stats();
+    if(stats.Entries > 0) std::cout << "Read " << stats.Bytes/stats.Entries << " bytes per entry on average for " << stats.Entries << " entries.\n";
+    if(stats.Selected > 0) std::cout << "Read " << stats.SelectedBytes/stats.Selected << " bytes per entry on average for the " << stats.Selected
+                                     << " entries written out.\n";
+
+    //Report how many entries each Filter kept.  Every Worker has the same Filters in the same order.
+    auto filterStats = workers.front()->FilterStats();
+    for(size_t worker = 1; worker < workers.size(); ++worker)
+    {
+      const auto counts = workers[worker]->FilterStats();
+      for(size_t filter = 0; filter < filterStats.size(); ++filter)
+      {
+        filterStats[filter].Passed += counts[filter].Passed;
+        filterStats[filter].Failed += counts[filter].Failed;
+      }
+    }
+    for(const auto& filter: filterStats)
+    {
+      std::cout << "Filter " << filter.Name << " kept " << filter.Passed << " of " << filter.Passed + filter.Failed << " entries it saw.\n";
+    }
+
+    //Report whatever else Reconstructors counted.  Every Worker's Reconstructors report the same counters in the same order.
+    auto recoStats = workers.front()->RecoStats();
+    for(size_t worker = 1; worker < workers.size(); ++worker)
+    {
+      const auto counts = workers[worker]->RecoStats();
+      for(size_t reco = 0; reco < recoStats.size(); ++reco)
+      {
+        for(size_t count = 0; count < recoStats[reco].Counts.size(); ++count) recoStats[reco].Counts[count].second += counts[reco].Counts[count].second;
+      }
+    }
+    for(const auto& reco: recoStats)
+    {
+      for(const auto& count: reco.Counts) std::cout << reco.Name << ": " << count.second << " " << count.first << "\n";
+    }
+
     //Write out the reconstruced TTree if there was any reconstruction done.  
     if(outFile)
     {
       if(!outTree) std::cerr << "Output file was created, but there is no output TTree!\n";
       outFile->cd();
-      outTree->Write(); //TODO: Create a friend TTree instead of copying the entire file to reduce size of reconstruction.  See Guang's port of 
-                        //      T2K FGD code for example of friend trees.
+      //A RecoEvents TTree has entries from every input file one after the other.  RunId and EventId repeat between 
+      //edep-sim files, so index it on which input file each entry came from and its entry number in that file.  To 
+      //attach it to the EDepSimEvents TTree from input file number N by hand:
+      //EDepSimEvents->SetAlias("File", "N"); EDepSimEvents->SetAlias("Entry", "Entry$"); EDepSimEvents->AddFriend("RecoEvents", "<OutputName>");
+      if(workers.front()->WritesFriend()) outTree->BuildIndex("File", "Entry");
+      outTree->Write();
+
+      //NeutronCands refer to the algorithms that made their clusters by ID.  Write the names that go with those IDs.
+      auto algNames = pers::AlgNames::Names();
+      outFile->WriteObject(&algNames, pers::AlgNames::ObjectName);
 
       //Copy geometry and edepsim PassThru information from last file (?)
       //TODO: Copy from all files
@@ -307,6 +418,22 @@ int main(int argc, const char** argv)
       outFile->Write(); //TODO: Is this necessary?
     }
     else std::cout << "No output file created, so nothing to write.  Histograms written when main() ends.\n";
+
+    //Each Worker's histograms are in its own TMemFile.  Add them all up in the real histogram file.  
+    if(!workerAnaFiles.empty())
+    {
+      workers.clear(); //Analyzers might still fill histograms in their destructors
+      workerAnaSentries.clear(); //Write histograms to the TMemFiles
+
+      TFileMerger merger(false);
+      if(!merger.OutputFile(config["analysis"]["FileName"].as<std::string>().c_str(), "RECREATE"))
+      {
+        std::cerr << "Could not create histogram file named " << config["analysis"]["FileName"] << " to merge histograms from each thread.\n";
+        return 3;
+      }
+      for(const auto& file: workerAnaFiles) merger.AddFile(file.get(), false);
+      merger.Merge();
+    }
   }
   catch(const std::exception& e)
   {
@@ -0,0 +1,266 @@
+//File: Products.h
+//Brief: Products keeps track of every branch that plugins produce or consume in one Worker.  A Reconstructor that
+//       Produce()s a branch registers the std::vector it fills, and plugins that Consume() that branch get a Handle
+//       that points straight at that std::vector.  So, a chain like GridNeutronHits -> MergedClusters works in
+//       a single job without writing anything to a TTree first.  Branches that nobody in this job produces are read
+//       from the input TTree instead.
+//
+//       Handle<T> looks like a TTreeReaderArray<T>, so plugins that used to read from a TTreeReaderArray
+//       barely need to change.
+//
+//       A Reconstructor configured with Compact: true writes MCHits and MCClusters as MCHitColumns and MCClusterColumns
+//       in a branch named <branch>Columns.  When a later job Consume()s <branch> and the input TTree only has
+//       <branch>Columns, Products reads the columns and Expand()s them into the std::vector that Handles look at.
+//
+//       NeutronCands read from a TTree written by another job refer to algorithms by that job's pers::AlgNames IDs.
+//       Give Products each input TTree's table with SetAlgIDs(), and it changes them to this process's IDs as they are read.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//util includes
+#include "Base/exception.h"
+
+//persistency includes
+#include "persistency/MCHitColumns.h"
+#include "persistency/MCClusterColumns.h"
+#include "persistency/NeutronCand.h"
+#include "persistency/AlgNames.h"
+
+//ROOT includes
+#include "TTree.h"
+#include "TBranch.h"
+
+//c++ includes
+#include <map>
+#include <vector>
+#include <string>
+#include <memory>
+#include <typeinfo>
+
+#ifndef PLGN_PRODUCTS_H
+#define PLGN_PRODUCTS_H
+
+namespace plgn
+{
+  class Products;
+
+  namespace detail
+  {
+    //Reads a product from a compact branch instead.  Most products don't have a compact form.
+    template <class T>
+    struct ColumnsReader
+    {
+      bool SetAddress(TTree& /*tree*/, const std::string& /*name*/, TBranch*& /*branch*/) { return false; }
+      void Expand(std::vector<T>& /*product*/) const {}
+    };
+
+    template <class COLUMNS, class T>
+    struct ExpandColumns
+    {
+      ExpandColumns(): fColumns(nullptr) {}
+      ~ExpandColumns() { delete fColumns; }
+
+      //Returns false if tree doesn't have a branch named name
+      bool SetAddress(TTree& tree, const std::string& name, TBranch*& branch)
+      {
+        if(!tree.GetBranch(name.c_str())) return false;
+        if(!fColumns) fColumns = new COLUMNS();
+        tree.SetBranchAddress(name.c_str(), &fColumns, &branch);
+        return true;
+      }
+
+      void Expand(std::vector<T>& product) const { fColumns->Expand(product); }
+
+      COLUMNS* fColumns; //Owned.  Filled from an input TTree.
+    };
+
+    template <>
+    struct ColumnsReader<pers::MCHit>: public ExpandColumns<pers::MCHitColumns, pers::MCHit> {};
+
+    template <>
+    struct ColumnsReader<pers::MCCluster>: public ExpandColumns<pers::MCClusterColumns, pers::MCCluster> {};
+
+    //Change algorithm IDs in products read from another job's file to this process's IDs.  Only NeutronCands have them.
+    template <class T>
+    void RemapAlgs(std::vector<T>& /*product*/, const std::vector<pers::AlgNames::ID_t>& /*ids*/) {}
+
+    inline void RemapAlgs(std::vector<pers::NeutronCand>& cands, const std::vector<pers::AlgNames::ID_t>& ids)
+    {
+      for(auto& cand: cands)
+      {
+        for(auto& alg: cand.ClusterAlgs)
+        {
+          if(alg >= ids.size()) throw util::exception("Products") << "A NeutronCand refers to algorithm ID " << alg << ", but its file's "
+                                                                  << pers::AlgNames::ObjectName << " table only has " << ids.size() << " names.\n";
+          alg = ids[alg];
+        }
+      }
+    }
+
+    //Where a Handle looks for a product.  Either points to a Reconstructor's std::vector or to fBuffer, which
+    //is filled from an input TTree.
+    class SlotBase
+    {
+      public:
+        SlotBase(const std::type_info& type): fType(type), fProduced(false), fBranch(nullptr), fAlgIDs(nullptr) {}
+        virtual ~SlotBase() = default;
+
+        virtual bool SetAddress(TTree& tree, const std::string& name) = 0; //Returns false if tree doesn't have name
+        virtual Long64_t GetEntry() = 0; //Read fBranch's current entry.  Returns the number of bytes read.
+        virtual void Clear() = 0; //Empty the product a Reconstructor made
+
+        const std::type_info& fType; //What kind of std::vector is in this Slot?
+        bool fProduced; //Has a Reconstructor promised to fill this Slot?
+        TBranch* fBranch; //Where to read this Slot from if it's not fProduced
+        const std::vector<pers::AlgNames::ID_t>* fAlgIDs; //This process's ID for each algorithm ID in fBranch's file.  nullptr if they're the same.
+    };
+
+    template <class T>
+    class Slot: public SlotBase
+    {
+      public:
+        Slot(): SlotBase(typeid(T)), fProduct(&fEmpty), fOutput(nullptr), fBuffer(nullptr), fEmpty(), fColumns(), fExpand(false) {}
+        virtual ~Slot() { delete fBuffer; }
+
+        virtual bool SetAddress(TTree& tree, const std::string& name) override
+        {
+          if(!fBuffer) fBuffer = new std::vector<T>();
+          fProduct = fBuffer;
+          fExpand = false;
+          if(tree.GetBranch(name.c_str()))
+          {
+            tree.SetBranchAddress(name.c_str(), &fBuffer, &fBranch);
+            return true;
+          }
+
+          fExpand = fColumns.SetAddress(tree, name+"Columns", fBranch);
+          return fExpand;
+        }
+
+        virtual Long64_t GetEntry() override
+        {
+          if(fProduced || !fBranch) return 0;
+          const Long64_t bytes = fBranch->GetEntry(fBranch->GetTree()->GetReadEntry());
+          if(fExpand) fColumns.Expand(*fBuffer);
+          if(fAlgIDs) RemapAlgs(*fBuffer, *fAlgIDs);
+          return bytes;
+        }
+
+        virtual void Clear() override
+        {
+          if(fOutput) fOutput->clear();
+        }
+
+        const std::vector<T>* fProduct; //Observer pointer to the std::vector Handles look at
+        std::vector<T>* fOutput; //Observer pointer to the std::vector a Reconstructor fills
+        std::vector<T>* fBuffer; //Owned.  Filled from an input TTree.
+        const std::vector<T> fEmpty; //What Handles look at until someone provides a product
+        ColumnsReader<T> fColumns; //Reads a compact branch into fBuffer when there is no branch with the product's name
+        bool fExpand; //Is fBranch a compact branch?
+    };
+  }
+
+  //Read-only access to a product.  Feels like a TTreeReaderArray<T>.
+  template <class T>
+  class Handle
+  {
+    public:
+      using const_iterator = typename std::vector<T>::const_iterator;
+
+      Handle(const detail::Slot<T>& slot): fSlot(&slot) {}
+
+      const_iterator begin() const { return fSlot->fProduct->begin(); }
+      const_iterator end() const { return fSlot->fProduct->end(); }
+      const T& operator [](const size_t index) const { return (*(fSlot->fProduct))[index]; }
+      size_t GetSize() const { return fSlot->fProduct->size(); }
+      size_t size() const { return GetSize(); }
+      bool empty() const { return fSlot->fProduct->empty(); }
+
+    private:
+      const detail::Slot<T>* fSlot; //Observer pointer to where my product is.  Owned by a Products.
+  };
+
+  class Products
+  {
+    public:
+      Products() = default;
+
+      //Plugins get products by name.  Throws a util::exception if name was already used for a different type.
+      template <class T>
+      Handle<T> Consume(const std::string& name)
+      {
+        return Handle<T>(GetSlot<T>(name));
+      }
+
+      //Reconstructors register where they put products.  Only one Reconstructor may produce each name.
+      template <class T>
+      void Produce(const std::string& name, std::vector<T>& product)
+      {
+        auto& slot = GetSlot<T>(name);
+        if(slot.fProduced) throw util::exception("Products") << "More than one Reconstructor produces a branch named " << name << ".\n";
+        slot.fProduced = true;
+        slot.fProduct = &product;
+        slot.fOutput = &product;
+      }
+
+      //Empty everything Reconstructors made so that skipped entries don't get products from the last entry.
+      void ClearProduced()
+      {
+        for(auto& slot: fSlots) slot.second->Clear();
+      }
+
+      //Point every product that no Reconstructor makes at a branch in tree.  Throws a util::exception if tree doesn't have it.
+      //Call SetAlgIDs() for tree and its friends first.
+      void SetInput(TTree& tree)
+      {
+        for(auto& slot: fSlots)
+        {
+          if(slot.second->fProduced) continue;
+          if(!slot.second->SetAddress(tree, slot.first))
+          {
+            throw util::exception("Products") << "A plugin needs a branch named " << slot.first << ", but no Reconstructor makes it "
+                                              << "and neither it nor " << slot.first << "Columns is in the input TTree.\n";
+          }
+
+          const auto found = fAlgIDs.find(slot.second->fBranch->GetTree()); //A friend's branches belong to the friend TTree
+          slot.second->fAlgIDs = (found != fAlgIDs.end())?&(found->second):nullptr;
+        }
+      }
+
+      //NeutronCands read from tree use the algorithm IDs in names, the AlgNames table from tree's file.  tree is an input 
+      //TTree or one of its friends.  
+      void SetAlgIDs(const TTree* tree, const std::vector<std::string>& names) { fAlgIDs[tree] = pers::AlgNames::Remap(names); }
+
+      //Forget AlgNames tables from TTrees that are about to be deleted
+      void ForgetAlgIDs(const TTree* tree) { fAlgIDs.erase(tree); }
+      void ClearAlgIDs() { fAlgIDs.clear(); }
+
+      //Read the products that come from the input TTree for entry and Expand() any that were written compactly.  
+      //tree->LoadTree(entry) must already have been called so that friend TTrees are on the right entry too.  Returns 
+      //the number of bytes read.
+      Long64_t GetEntry()
+      {
+        Long64_t bytes = 0;
+        for(auto& slot: fSlots) bytes += slot.second->GetEntry();
+        return bytes;
+      }
+
+    private:
+      template <class T>
+      detail::Slot<T>& GetSlot(const std::string& name)
+      {
+        auto found = fSlots.find(name);
+        if(found == fSlots.end()) found = fSlots.emplace(name, std::unique_ptr<detail::SlotBase>(new detail::Slot<T>())).first;
+        if(found->second->fType != typeid(T))
+        {
+          throw util::exception("Products") << "Branch " << name << " holds " << found->second->fType.name() << ", but a plugin asked "
+                                            << "for it as " << typeid(T).name() << ".\n";
+        }
+        return static_cast<detail::Slot<T>&>(*(found->second));
+      }
+
+      std::map<std::string, std::unique_ptr<detail::SlotBase>> fSlots; //Every product anyone asked for by name
+      std::map<const TTree*, std::vector<pers::AlgNames::ID_t>> fAlgIDs; //This process's ID for each algorithm ID in each input TTree
+  };
+}
+
+#endif //PLGN_PRODUCTS_H
@@ -0,0 +1,191 @@
+//File: Scheduler.cpp
+//Brief: A Scheduler runs Reconstructors in an order that respects the products they Consume() and Produce().
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//app includes
+#include "app/Scheduler.h"
+
+//Plugin includes
+#include "reco/Reconstructor.h"
+#include "reco/Filter.h"
+
+//util includes
+#include "Base/exception.h"
+
+//c++ includes
+#include <map>
+#include <algorithm>
+
+namespace app
+{
+  Scheduler::Scheduler(const std::vector<std::pair<std::string, plgn::Reconstructor*>>& recos, const size_t nTasks): fNodes(), fFilters(), fLayers(),
+                                                                                                                      fTasks(), fPool(nTasks)
+  {
+    for(const auto& reco: recos) fNodes.push_back(Node{reco.first, reco.second, false, 0, 0});
+
+    //Filters always run first, so they don't need to be in the graph
+    std::vector<bool> isFilter(fNodes.size(), false);
+    for(size_t node = 0; node < fNodes.size(); ++node)
+    {
+      if(dynamic_cast<plgn::Filter*>(fNodes[node].Reco))
+      {
+        isFilter[node] = true;
+        fFilters.push_back(node);
+      }
+    }
+
+    //Who makes each product?  Products from Filters are always ready before anything else runs.
+    std::map<std::string, size_t> producers, writers;
+    for(size_t node = 0; node < fNodes.size(); ++node)
+    {
+      for(const auto& product: fNodes[node].Reco->Produced())
+      {
+        const auto found = producers.find(product);
+        if(found != producers.end())
+        {
+          throw util::exception("Scheduler") << "Both " << fNodes[found->second].Name << " and " << fNodes[node].Name << " produce a branch named "
+                                             << product << ".\n";
+        }
+        producers[product] = node;
+      }
+
+      //A compact branch could have the same name as someone else's product
+      for(const auto& output: fNodes[node].Reco->Outputs())
+      {
+        const auto found = writers.find(output);
+        if(found != writers.end())
+        {
+          throw util::exception("Scheduler") << "Both " << fNodes[found->second].Name << " and " << fNodes[node].Name << " write a branch named "
+                                             << output << ".\n";
+        }
+        writers[output] = node;
+      }
+    }
+
+    for(const auto filter: fFilters)
+    {
+      for(const auto& input: fNodes[filter].Reco->Inputs())
+      {
+        const auto found = producers.find(input);
+        if(found != producers.end() && !isFilter[found->second])
+        {
+          throw util::exception("Scheduler") << "Filter " << fNodes[filter].Name << " needs " << input << " from " << fNodes[found->second].Name 
+                                             << ", but Filters run before every other Reconstructor.\n";
+        }
+      }
+    }
+
+    //Draw an edge from each producer to each Reconstructor that consumes its products
+    std::vector<std::set<size_t>> children(fNodes.size());
+    std::vector<size_t> nParents(fNodes.size(), 0);
+    for(size_t node = 0; node < fNodes.size(); ++node)
+    {
+      for(const auto& input: fNodes[node].Reco->Inputs())
+      {
+        const auto found = producers.find(input);
+        if(found != producers.end() && !isFilter[found->second] && children[found->second].insert(node).second) ++nParents[node];
+      }
+    }
+
+    //Peel off layers of Reconstructors whose parents have all been scheduled already.  Keeps the configuration order within a layer.
+    std::vector<size_t> ready;
+    for(size_t node = 0; node < fNodes.size(); ++node) if(nParents[node] == 0 && !isFilter[node]) ready.push_back(node);
+
+    size_t nScheduled = fFilters.size();
+    while(!ready.empty())
+    {
+      fLayers.push_back(ready);
+      nScheduled += ready.size();
+
+      std::vector<size_t> next;
+      for(const auto node: ready)
+      {
+        for(const auto child: children[node]) if(--nParents[child] == 0) next.push_back(child);
+      }
+      std::sort(next.begin(), next.end());
+      ready = next;
+    }
+
+    if(nScheduled < fNodes.size())
+    {
+      util::exception except("Scheduler");
+      except << "These Reconstructors need each other's products in a cycle, so none of them can run:\n";
+      for(size_t node = 0; node < fNodes.size(); ++node) if(nParents[node] > 0) except << fNodes[node].Name << "\n";
+      throw except;
+    }
+
+    //Make each layer's tasks once instead of on every event
+    for(const auto& layer: fLayers)
+    {
+      fTasks.emplace_back();
+      for(const auto node: layer)
+      {
+        auto& toRun = fNodes[node];
+        fTasks.back().push_back([&toRun]() { toRun.Found = toRun.Reco->Reconstruct(); });
+      }
+    }
+  }
+
+  bool Scheduler::Filter()
+  {
+    for(const auto filter: fFilters)
+    {
+      auto& node = fNodes[filter];
+      node.Found = node.Reco->Reconstruct();
+      if(!node.Found)
+      {
+        ++node.Failed;
+        return false;
+      }
+      ++node.Passed;
+    }
+
+    return true;
+  }
+
+  bool Scheduler::Reconstruct()
+  {
+    for(const auto& layer: fTasks) fPool.Run(layer);
+
+    //Filters found something if they kept this event
+    return std::any_of(fNodes.begin(), fNodes.end(), [](const auto& node) { return node.Found; });
+  }
+
+  std::set<std::string> Scheduler::FilterInputs() const
+  {
+    std::set<std::string> inputs;
+    for(const auto filter: fFilters) inputs.insert(fNodes[filter].Reco->Inputs().begin(), fNodes[filter].Reco->Inputs().end());
+    return inputs;
+  }
+
+  std::vector<Scheduler::FilterCounts> Scheduler::FilterStats() const
+  {
+    std::vector<FilterCounts> stats;
+    for(const auto filter: fFilters) stats.push_back(FilterCounts{fNodes[filter].Name, fNodes[filter].Passed, fNodes[filter].Failed});
+    return stats;
+  }
+
+  std::vector<Scheduler::RecoCounts> Scheduler::RecoStats() const
+  {
+    std::vector<RecoCounts> stats;
+    for(const auto& node: fNodes) stats.push_back(RecoCounts{node.Name, node.Reco->Stats()});
+    return stats;
+  }
+
+  void Scheduler::Print(std::ostream& os) const
+  {
+    if(!fFilters.empty())
+    {
+      os << "Filters:";
+      for(const auto filter: fFilters) os << " " << fNodes[filter].Name;
+      os << "\n";
+    }
+
+    for(size_t layer = 0; layer < fLayers.size(); ++layer)
+    {
+      os << "Layer " << layer << ":";
+      for(const auto node: fLayers[layer]) os << " " << fNodes[node].Name;
+      os << "\n";
+    }
+  }
+}
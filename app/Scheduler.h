@@ -0,0 +1,93 @@
+//File: Scheduler.h
+//Brief: A Scheduler decides what order to run Reconstructors in based on which branches each one Produce()s and
+//       Consume()s.  A Reconstructor always runs after every Reconstructor that makes something it needs, regardless
+//       of the order they were listed in under "reco: algs".  Reconstructors that need products from each other in a
+//       circle can never run, so the Scheduler throws a util::exception as soon as it is created.
+//
+//       Reconstructors are grouped into layers.  Nothing in a layer needs anything else in that same layer, so all of
+//       the Reconstructors in a layer can run at the same time on a TaskPool.
+//
+//       plgn::Filters are not part of any layer.  They run one at a time in configuration order before everything 
+//       else, and the first one that rejects an event stops the chain.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//app includes
+#include "app/TaskPool.h"
+
+//c++ includes
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <ostream>
+#include <set>
+#include <utility>
+
+#ifndef APP_SCHEDULER_H
+#define APP_SCHEDULER_H
+
+namespace plgn
+{
+  class Reconstructor;
+}
+
+namespace app
+{
+  class Scheduler
+  {
+    public:
+      //How many events a Filter kept and threw away
+      struct FilterCounts
+      {
+        std::string Name;
+        size_t Passed;
+        size_t Failed;
+      };
+
+      //What a Reconstructor counted with plgn::Reconstructor::Stats()
+      struct RecoCounts
+      {
+        std::string Name;
+        std::vector<std::pair<std::string, size_t>> Counts;
+      };
+
+      //Order the Reconstructors in recos.  Each one is named by the key it had in the configuration document.  Runs up to
+      //nTasks Reconstructors at the same time.
+      Scheduler(const std::vector<std::pair<std::string, plgn::Reconstructor*>>& recos, const size_t nTasks);
+
+      //Run each Filter on the current event until one of them rejects it.  Returns true if every Filter kept the event.
+      bool Filter();
+
+      //Run every Reconstructor that's not a Filter once on the current event.  Call only after Filter() returned true.  
+      //Returns true if any Reconstructor reconstructed something or if there are Filters that all kept this event.  
+      bool Reconstruct();
+
+      //Names of branches Filters need to decide whether to keep an event
+      std::set<std::string> FilterInputs() const;
+
+      std::vector<FilterCounts> FilterStats() const;
+      std::vector<RecoCounts> RecoStats() const; //Every Reconstructor and Filter in configuration order
+      bool HasFilters() const { return !fFilters.empty(); }
+
+      //Print the order Reconstructors will run in
+      void Print(std::ostream& os) const;
+
+    private:
+      struct Node
+      {
+        std::string Name; //Key from the configuration document
+        plgn::Reconstructor* Reco; //Observer pointer
+        bool Found; //What Reco->Reconstruct() returned on the last event
+        size_t Passed; //Number of times Reco->Reconstruct() returned true
+        size_t Failed; //Number of times Reco->Reconstruct() returned false
+      };
+
+      std::vector<Node> fNodes;
+      std::vector<size_t> fFilters; //Indices into fNodes of plgn::Filters in configuration order
+      std::vector<std::vector<size_t>> fLayers; //Indices into fNodes.  Each layer only depends on layers before it.
+      std::vector<std::vector<std::function<void()>>> fTasks; //Tasks for each layer, made once
+      TaskPool fPool;
+  };
+}
+
+#endif //APP_SCHEDULER_H
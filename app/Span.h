@@ -0,0 +1,43 @@
+//File: Span.h
+//Brief: A Span is a read-only view of a contiguous range of Ts that it doesn't own.  Copying a Span just copies 2
+//       pointers, so plugins can write const auto trajs = fEvent.Trajectories() without copying every TG4Trajectory 
+//       and all of its TG4TrajectoryPoints like they did when that was a std::vector.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//c++ includes
+#include <vector>
+#include <cstddef>
+
+#ifndef PLGN_SPAN_H
+#define PLGN_SPAN_H
+
+namespace plgn
+{
+  template <class T>
+  class Span
+  {
+    public:
+      using value_type = T;
+      using const_iterator = const T*;
+
+      Span(): fBegin(nullptr), fEnd(nullptr) {}
+      Span(const T* begin, const T* end): fBegin(begin), fEnd(end) {}
+      Span(const std::vector<T>& vec): fBegin(vec.data()), fEnd(vec.data() + vec.size()) {}
+
+      const_iterator begin() const { return fBegin; }
+      const_iterator end() const { return fEnd; }
+
+      const T& operator [](const size_t index) const { return fBegin[index]; }
+      const T& front() const { return *fBegin; }
+      const T& back() const { return *(fEnd - 1); }
+
+      size_t size() const { return fEnd - fBegin; }
+      bool empty() const { return fBegin == fEnd; }
+
+    private:
+      const T* fBegin;
+      const T* fEnd;
+  };
+}
+
+#endif //PLGN_SPAN_H
@@ -0,0 +1,88 @@
+//File: TaskPool.cpp
+//Brief: A TaskPool runs a batch of independent tasks on a few threads that it keeps around between batches.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//app includes
+#include "app/TaskPool.h"
+
+namespace app
+{
+  TaskPool::TaskPool(const size_t nThreads): fThreads(), fMutex(), fWake(), fDone(), fBatch(), fGeneration(0), fStop(false)
+  {
+    for(size_t thread = 1; thread < nThreads; ++thread) fThreads.emplace_back([this]() { Loop(); });
+  }
+
+  TaskPool::~TaskPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fStop = true;
+    }
+    fWake.notify_all();
+    for(auto& thread: fThreads) thread.join();
+  }
+
+  void TaskPool::Run(const std::vector<std::function<void()>>& tasks)
+  {
+    //Don't bother waking anyone up if there is nothing to share
+    if(fThreads.empty() || tasks.size() < 2)
+    {
+      for(const auto& task: tasks) task();
+      return;
+    }
+
+    auto batch = std::make_shared<Batch>(tasks);
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fBatch = batch;
+      ++fGeneration;
+    }
+    fWake.notify_all();
+
+    Work(*batch);
+
+    std::unique_lock<std::mutex> lock(fMutex);
+    fDone.wait(lock, [&batch]() { return batch->fRemaining == 0; });
+    fBatch.reset();
+    if(batch->fError) std::rethrow_exception(batch->fError);
+  }
+
+  void TaskPool::Work(Batch& batch)
+  {
+    for(size_t task = batch.fNext++; task < batch.fSize; task = batch.fNext++)
+    {
+      try
+      {
+        (*batch.fTasks)[task]();
+      }
+      catch(...) //util::exception doesn't derive from std::exception
+      {
+        std::lock_guard<std::mutex> lock(fMutex);
+        if(!batch.fError) batch.fError = std::current_exception();
+      }
+
+      if(--batch.fRemaining == 0)
+      {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fDone.notify_all();
+      }
+    }
+  }
+
+  void TaskPool::Loop()
+  {
+    size_t lastGeneration = 0;
+    while(true)
+    {
+      std::shared_ptr<Batch> batch;
+      {
+        std::unique_lock<std::mutex> lock(fMutex);
+        fWake.wait(lock, [this, lastGeneration]() { return fStop || (fBatch && fGeneration != lastGeneration); });
+        if(fStop) return;
+        lastGeneration = fGeneration;
+        batch = fBatch;
+      }
+      Work(*batch);
+    }
+  }
+}
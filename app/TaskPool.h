@@ -0,0 +1,64 @@
+//File: TaskPool.h
+//Brief: A TaskPool runs a batch of independent tasks on a few threads that it keeps around between batches.  The thread
+//       that calls Run() works on the batch too, so a TaskPool with 1 thread doesn't start any new threads at all.
+//       The Scheduler uses a TaskPool to run Reconstructors that don't depend on each other at the same time.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//c++ includes
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <exception>
+
+#ifndef APP_TASKPOOL_H
+#define APP_TASKPOOL_H
+
+namespace app
+{
+  class TaskPool
+  {
+    public:
+      TaskPool(const size_t nThreads); //Including the thread that calls Run()
+      ~TaskPool();
+
+      TaskPool(const TaskPool&) = delete;
+      TaskPool& operator =(const TaskPool&) = delete;
+
+      //Run every task in tasks and return when they are all done.  If any task throws, rethrows the first exception
+      //after all tasks have finished.
+      void Run(const std::vector<std::function<void()>>& tasks);
+
+    private:
+      //Everything about one call to Run().  Threads that wake up late only ever see a Batch with nothing left to do.
+      struct Batch
+      {
+        Batch(const std::vector<std::function<void()>>& tasks): fTasks(&tasks), fSize(tasks.size()), fNext(0), fRemaining(tasks.size()), 
+                                                                 fError() {}
+
+        //fTasks is only valid until Run() returns.  Run() can't return until every task that was started has finished, 
+        //so only look at fTasks after getting a task index less than fSize.
+        const std::vector<std::function<void()>>* fTasks;
+        const size_t fSize;
+        std::atomic<size_t> fNext; //Index of the next task to start
+        std::atomic<size_t> fRemaining; //Number of tasks that haven't finished
+        std::exception_ptr fError; //First exception thrown by a task.  Guarded by TaskPool::fMutex.
+      };
+
+      void Work(Batch& batch); //Run tasks from batch until there are none left to start
+      void Loop(); //What each thread in fThreads does until this TaskPool is destroyed
+
+      std::vector<std::thread> fThreads;
+      std::mutex fMutex; //Guards everything below
+      std::condition_variable fWake; //Tells fThreads there is a new Batch or that it's time to stop
+      std::condition_variable fDone; //Tells Run() that a Batch is finished
+      std::shared_ptr<Batch> fBatch; //The Batch currently being worked on
+      size_t fGeneration; //Incremented for each new Batch so that threads don't work on the same Batch twice
+      bool fStop; //Set when this TaskPool is being destroyed
+  };
+}
+
+#endif //APP_TASKPOOL_H
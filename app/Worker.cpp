@@ -0,0 +1,440 @@
+//File: Worker.cpp
+//Brief: A Worker runs its own copies of all Reconstructor and Analyzer plugins over a range of entries in an edepsim file.
+//       Everything a Worker touches while processing entries is owned by that Worker, so several Workers can process
+//       different entries of the same file at the same time.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//app includes
+#include "app/Worker.h"
+#include "app/Factory.cpp"
+
+//Plugin includes
+#include "ana/Analyzer.h"
+#include "reco/Reconstructor.h"
+#include "persistency/AlgNames.h"
+
+//util includes
+#include "ROOT/Base/TFileSentry.h"
+#include "Base/exception.h"
+
+//ROOT includes
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TFriendElement.h"
+#include "TGeoManager.h"
+
+//c++ includes
+#include <iostream>
+
+namespace app
+{
+  constexpr const char* Worker::FriendTreeName;
+
+  Worker::Worker(const YAML::Node& config, const std::string& firstFile, const std::string& firstFriend, TDirectory* outDir, 
+                 util::TFileSentry* anaFile): fFileName(), fFileNumber(0), fFriendName(), fFriendFileNumber(0), fFriendTree(nullptr), 
+                 fFriendRunIdBranch(nullptr), fFriendEventIdBranch(nullptr), fFriendRunId(0), fFriendEventId(0), fFile(nullptr), fInTree(nullptr), fProducts(), 
+                 fGeometry((config["app"] && config["app"]["fiducial"])?config["app"]["fiducial"].as<std::string>():"volA3DST_PV"), 
+                 fSegments(), fTruth(), fEvent(), fEventBranch(nullptr), fFilterBranches(), fLateBranches(), fStats{0, 0, 0, 0}, fInputs(), 
+                 fFriend(false), fEntry(0),
+                 fRunId(0), fEventId(0), fOutTree(nullptr), fOwnsOutput(false), fAnaFile(anaFile), fRecoAlgs(), fAnaAlgs(), 
+                 fScheduler()
+  {
+    SetFile(firstFile, 0, firstFriend, 0);
+
+    if(config["reco"])
+    {
+      const auto mode = config["reco"]["output"]?config["reco"]["output"].as<std::string>():"clone";
+      if(mode == "friend") fFriend = true;
+      else if(mode != "clone") throw util::exception("Worker") << "Unknown reco output mode " << mode << ".  Options are clone and friend.\n";
+
+      if(fFriend)
+      {
+        //Create a TTree with just enough information to line up with the input tree
+        fOutTree = new TTree(FriendTreeName, "Reconstructed objects for EDepSimEvents");
+        fOutTree->SetDirectory(outDir);
+        fOutTree->Branch("File", &fFileNumber);
+        fOutTree->Branch("Entry", &fEntry);
+        fOutTree->Branch("RunId", &fRunId);
+        fOutTree->Branch("EventId", &fEventId);
+      }
+      else
+      {
+        //Create a copy of the structure of the input tree
+        fOutTree = fInTree->CloneTree(0);
+        fOutTree->SetDirectory(outDir);
+      }
+      fOwnsOutput = (outDir == nullptr); //Nobody else knows about a memory-resident stage
+
+      plgn::Reconstructor::Config recoConfig;
+      recoConfig.CurrentEvent = &fEvent;
+      recoConfig.Registry = &fProducts;
+      recoConfig.Geometry = &fGeometry;
+      recoConfig.Segments = &fSegments;
+      recoConfig.Truth = &fTruth;
+      recoConfig.Output = fOutTree;
+
+      const auto& recos = config["reco"]["algs"];
+      auto& recoFactory = plgn::Factory<plgn::Reconstructor>::instance();
+      for(auto reco = recos.begin(); reco != recos.end(); ++reco)
+      {
+        recoConfig.Options = reco->second;
+        auto recoAlg = recoFactory.Get(reco->first.as<std::string>(), recoConfig);
+        if(recoAlg) fRecoAlgs.emplace_back(reco->first.as<std::string>(), std::move(recoAlg));
+        else std::cerr << "Could not find Reconstructor algorithm " << reco->first << "\n";
+      }
+    }
+
+    //Decide what order to run Reconstructors in.  Throws if that's impossible.
+    size_t nTasks = 1;
+    if(config["app"] && config["app"]["tasks"]) nTasks = config["app"]["tasks"].as<size_t>();
+    std::vector<std::pair<std::string, plgn::Reconstructor*>> toSchedule;
+    for(const auto& reco: fRecoAlgs) toSchedule.emplace_back(reco.first, reco.second.get());
+    fScheduler.reset(new Scheduler(toSchedule, nTasks));
+
+    if(config["analysis"])
+    {
+      plgn::Analyzer::Config anaConfig;
+      anaConfig.File = fAnaFile;
+      anaConfig.CurrentEvent = &fEvent;
+      anaConfig.Registry = &fProducts;
+      anaConfig.Segments = &fSegments;
+      anaConfig.Truth = &fTruth;
+
+      const auto& anas = config["analysis"]["algs"];
+      auto& anaFactory = plgn::Factory<plgn::Analyzer>::instance();
+      for(auto ana = anas.begin(); ana != anas.end(); ++ana)
+      {
+        anaConfig.Options = ana->second;
+        fAnaFile->cd(ana->first.as<std::string>());
+        auto anaAlg = anaFactory.Get(ana->first.as<std::string>(), anaConfig);
+        if(anaAlg) fAnaAlgs.emplace_back(ana->first.as<std::string>(), std::move(anaAlg));
+        else std::cerr << "Could not find Analyzer algorithm " << ana->first << "\n";
+      }
+    }
+
+    //Now that I know what plugins need, stop reading everything else
+    std::set<std::string> produced;
+    for(const auto& reco: fRecoAlgs)
+    {
+      fInputs.insert(reco.second->Inputs().begin(), reco.second->Inputs().end());
+      produced.insert(reco.second->Produced().begin(), reco.second->Produced().end());
+    }
+
+    //A clone of EDepSimEvents copies NeutronCands from an earlier job.  Read them through fProducts so that their 
+    //algorithm IDs are changed to this job's like any other NeutronCands that plugins read.
+    if(fOutTree && !fFriend)
+    {
+      for(auto obj: *(fInTree->GetListOfBranches()))
+      {
+        const std::string name = obj->GetName();
+        if(std::string(((TBranch*)obj)->GetClassName()) != "vector<pers::NeutronCand>" || produced.count(name)) continue;
+        fProducts.Consume<pers::NeutronCand>(name);
+        fInputs.insert(name);
+      }
+    }
+    for(const auto& ana: fAnaAlgs) fInputs.insert(ana.second->Inputs().begin(), ana.second->Inputs().end());
+    fInputs.insert("RunId");
+    fInputs.insert("EventId");
+    for(const auto& input: fInputs)
+    {
+      if(!fInTree->GetBranch(input.c_str()) && !fInTree->GetBranch((input+"Columns").c_str()) && produced.count(input) == 0)
+      {
+        std::cerr << "A plugin needs a branch named " << input << ", but it is not in " << fFileName << ", and no Reconstructor makes it.\n";
+      }
+    }
+
+    //Now that plugins have added their branches and asked for their products, point everything at the right objects
+    SetFile(fFileName, fFileNumber, fFriendName, fFriendFileNumber);
+  }
+
+  Worker::~Worker()
+  {
+    //Plugins might still refer to fOutTree's branches, so get rid of them first.
+    fScheduler.reset();
+    fAnaAlgs.clear();
+    fRecoAlgs.clear();
+    if(fOwnsOutput) delete fOutTree;
+  }
+
+  void Worker::SetFile(const std::string& fileName, const Int_t fileNumber, const std::string& friendName, const Int_t friendFileNumber)
+  {
+    //NeutronApp loads each file's geometry into gGeoManager before calling SetFile().  Volumes from the last file might 
+    //not be in the same places.  
+    fGeometry.SetGeometry(gGeoManager);
+
+    if(fileName != fFileName || !fFile)
+    {
+      fProducts.ClearAlgIDs(); //The last file's TTrees are about to be deleted
+      fFile.reset(TFile::Open(fileName.c_str(), "READ"));
+      if(!fFile) throw util::exception("Worker") << "Could not open file " << fileName << " for reading.\n";
+      fFileName = fileName;
+
+      fInTree = (TTree*)fFile->Get("EDepSimEvents");
+      if(!fInTree) throw util::exception("Worker") << "Could not find TTree named EDepSimEvents in " << fileName << ".\n";
+      fFriendName.clear(); //This TTree doesn't have any friends yet
+      fFriendTree = nullptr;
+
+      //NeutronCands copied from an earlier clone-mode job refer to algorithms by ID in that job's AlgNames table
+      ReadAlgNames(*fFile, *fInTree);
+
+      //Read every TG4Event into the same object.  Process() reads it exactly once per entry.
+      fInTree->SetBranchAddress("Event", fEvent.Address(), &fEventBranch);
+      if(!fEventBranch) throw util::exception("Worker") << "Could not find a branch named Event in EDepSimEvents from " << fileName << ".\n";
+    }
+    fFileNumber = fileNumber;
+
+    //Make objects from an earlier friend-mode job visible to plugins as if they were in EDepSimEvents.  The same friend file 
+    //might be attached to a different input file, so check even if fileName didn't change.  
+    if(friendName != fFriendName || friendFileNumber != fFriendFileNumber)
+    {
+      if(!fFriendName.empty())
+      {
+        auto oldFriend = fInTree->GetFriend(FriendTreeName);
+        fProducts.ForgetAlgIDs(oldFriend);
+        fInTree->RemoveFriend(oldFriend);
+        fFriendTree = nullptr;
+      }
+      fFriendName = friendName;
+      fFriendFileNumber = friendFileNumber;
+
+      if(!friendName.empty())
+      {
+        auto element = fInTree->AddFriend(FriendTreeName, friendName.c_str());
+        if(!element || !element->GetTree()) throw util::exception("Worker") << "Could not find a TTree named " << FriendTreeName << " in " << friendName << ".\n";
+
+        //RecoEvents is indexed on (File, Entry).  ROOT looks up the friend entry for an EDepSimEvents entry by evaluating 
+        //File and Entry in EDepSimEvents, so tell EDepSimEvents what they mean for this input file.
+        fInTree->SetAlias("File", std::to_string(friendFileNumber).c_str());
+        fInTree->SetAlias("Entry", "Entry$");
+
+        //The index only knows about File and Entry.  Process() makes sure each row it finds is for the same event.
+        fFriendTree = element->GetTree();
+        fFriendTree->SetBranchAddress("RunId", &fFriendRunId, &fFriendRunIdBranch);
+        fFriendTree->SetBranchAddress("EventId", &fFriendEventId, &fFriendEventIdBranch);
+        if(!fFriendRunIdBranch || !fFriendEventIdBranch) throw util::exception("Worker") << FriendTreeName << " in " << friendName << " doesn't have RunId and EventId branches.\n";
+
+        //NeutronCands from that job refer to algorithms by ID in its AlgNames table
+        std::unique_ptr<TFile> friendFile(TFile::Open(friendName.c_str(), "READ"));
+        if(friendFile) ReadAlgNames(*friendFile, *element->GetTree());
+      }
+    }
+
+    //Products that no Reconstructor makes are read from the input TTree.  Do this before copying addresses 
+    //so that fOutTree writes the same objects.
+    fProducts.SetInput(*fInTree);
+
+    //Always copy addresses again.  Deleting any TTree fOutTree was cloned from resets fOutTree's addresses.  
+    //This also points fOutTree's Event branch at fEvent, so the TG4Event that was just read is the one that gets written.
+    if(fOutTree && !fFriend) fInTree->CopyAddresses(fOutTree);
+    PruneBranches();
+  }
+
+  void Worker::ReadAlgNames(TFile& file, const TTree& tree)
+  {
+    std::vector<std::string>* algNames = nullptr;
+    file.GetObject(pers::AlgNames::ObjectName, algNames);
+    if(!algNames) return; //Not written by NeutronApp.  Any NeutronCands are version 1, which get this job's IDs as they're read.
+
+    fProducts.SetAlgIDs(&tree, *algNames);
+    delete algNames;
+  }
+
+  void Worker::CheckFriend(const Long64_t entry)
+  {
+    if(!fFriendTree) return;
+
+    //LoadTree() moves a friend TTree to a negative entry when its index has no row for (File, Entry).  Its branches 
+    //would keep the last entry's objects.
+    const Long64_t friendEntry = fFriendTree->GetReadEntry();
+    if(friendEntry < 0)
+    {
+      throw util::exception("Worker") << FriendTreeName << " in " << fFriendName << " has no entry for File " << fFriendFileNumber 
+                                      << " and Entry " << entry << " from " << fFileName << ".  Was it written from the same "
+                                      << "input files in the same order and with enough events?\n";
+    }
+
+    //PruneBranches() disables these, so read them even if they're turned off
+    fFriendRunIdBranch->GetEntry(friendEntry, 1);
+    fFriendEventIdBranch->GetEntry(friendEntry, 1);
+    if(fFriendRunId != fEvent->RunId || fFriendEventId != fEvent->EventId)
+    {
+      throw util::exception("Worker") << "Entry " << entry << " of " << fFileName << " is RunId " << fEvent->RunId << " and EventId "
+                                      << fEvent->EventId << ", but the entry for it in " << FriendTreeName << " from " << fFriendName 
+                                      << " is RunId " << fFriendRunId << " and EventId " << fFriendEventId << ".  File " 
+                                      << fFriendFileNumber << " in " << fFriendName << " must have been a different input file.  "
+                                      << "List input files in the same order as the job that wrote " << fFriendName << ".\n";
+    }
+  }
+
+  void Worker::PruneBranches()
+  {
+    //These TBranches belong to the last file
+    fFilterBranches.clear();
+    fLateBranches.clear();
+
+    if(fInputs.empty()) return; //Plugins haven't told me what they need yet
+
+    fInTree->SetBranchStatus("*", false);
+    fInTree->SetCacheSize(); //ROOT's default cache size
+    for(const auto& input: fInputs)
+    {
+      auto name = input;
+      if(!fInTree->GetBranch(name.c_str())) name += "Columns"; //Written by a Reconstructor with Compact: true
+      if(!fInTree->GetBranch(name.c_str())) continue; //Made by a Reconstructor in this job instead
+      fInTree->SetBranchStatus(name.c_str(), true); //Also enables sub-branches
+      fInTree->AddBranchToCache(name.c_str(), true);
+    }
+
+    //The Event branch itself has to be read for any of its sub-branches to be read.  Enabling it with SetBranchStatus() 
+    //would enable all of its sub-branches too.
+    fEventBranch->ResetBit(TBranch::kDoNotProcess);
+    fInTree->StopCacheLearningPhase();
+
+    //Split the parts of the TG4Event that will be read into what Filters need and everything else
+    if(!fScheduler || !fScheduler->HasFilters()) return;
+
+    auto filterInputs = fScheduler->FilterInputs();
+    filterInputs.insert("RunId");
+    filterInputs.insert("EventId");
+    for(auto obj: *(fEventBranch->GetListOfBranches()))
+    {
+      auto branch = (TBranch*)obj;
+      if(branch->TestBit(TBranch::kDoNotProcess)) continue;
+      if(filterInputs.count(branch->GetName())) fFilterBranches.push_back(branch);
+      else fLateBranches.push_back(branch);
+    }
+  }
+
+  void Worker::Process(const Long64_t begin, const Long64_t end)
+  {
+    for(Long64_t entry = begin; entry < end; ++entry)
+    {
+      fInTree->LoadTree(entry); //Also moves friend TTrees to this entry
+      Long64_t eventBytes = 0;
+      Long64_t otherBytes = 0;
+
+      if(fScheduler->HasFilters())
+      {
+        //Only read what Filters need to decide whether the rest of this entry is worth reading
+        for(auto branch: fFilterBranches) eventBytes += branch->GetEntry(entry);
+        CheckFriend(entry);
+        eventBytes += fProducts.GetEntry();
+
+        if(!fScheduler->Filter())
+        {
+          ++fStats.Entries;
+          fStats.Bytes += eventBytes;
+
+          //Keep a friend TTree lined up with EDepSimEvents, but don't write products left over from the last entry
+          if(fFriend)
+          {
+            fProducts.ClearProduced();
+            for(const auto& reco: fRecoAlgs) reco.second->Compact(); //Compact branches are separate from the products
+            fEntry = entry;
+            fRunId = fEvent->RunId;
+            fEventId = fEvent->EventId;
+            fOutTree->Fill();
+            ++fStats.Selected;
+            fStats.SelectedBytes += eventBytes;
+          }
+          continue; //No other plugin sees this entry
+        }
+
+        for(auto branch: fLateBranches) eventBytes += branch->GetEntry(entry);
+      }
+      else
+      {
+        eventBytes = fEventBranch->GetEntry(entry); //Read everything plugins need before any of them run
+        CheckFriend(entry);
+        eventBytes += fProducts.GetEntry();
+      }
+
+      //Convert TG4HitSegments to local coordinates once for every plugin that needs them
+      if(fSegments.Requested()) fSegments.Fill(*fEvent, fGeometry.Fiducial());
+
+      //Same for the TG4Trajectory family tree
+      if(fTruth.Requested()) fTruth.Fill(fEvent->Trajectories);
+
+      //First, call Reconstructor plugins
+      const bool foundReco = fScheduler->Reconstruct();
+
+      //A friend TTree needs an entry for every input entry so that it lines up with EDepSimEvents.  
+      //It doesn't have a copy of the TG4Event, so there's nothing else to read.
+      if(fFriend)
+      {
+        fEntry = entry;
+        fRunId = fEvent->RunId;
+        fEventId = fEvent->EventId;
+        fOutTree->Fill();
+      }
+      //If something was reconstructed, write to the output tree
+      else if(foundReco)
+      {
+        //fEvent already has the parts of this entry's TG4Event that plugins asked for.  Read the parts nobody needed and 
+        //whatever else the input TTree has, like objects from an earlier job, so that they get copied too.  
+        for(auto obj: *(fEventBranch->GetListOfBranches()))
+        {
+          auto branch = (TBranch*)obj;
+          if(branch->TestBit(TBranch::kDoNotProcess)) otherBytes += branch->GetEntry(entry, 1);
+        }
+        for(auto obj: *(fInTree->GetListOfBranches()))
+        {
+          auto branch = (TBranch*)obj;
+          if(branch != fEventBranch && branch->TestBit(TBranch::kDoNotProcess)) otherBytes += branch->GetEntry(entry, 1);
+        }
+        if(!fOutTree) std::cerr << "Did some reconstruction, but output TTree has not been created!\n"; //TODO: This is only debugging output.  Remove it from release builds?
+        fOutTree->Fill();
+      }
+
+      ++fStats.Entries;
+      fStats.Bytes += eventBytes + otherBytes;
+      if(foundReco || fFriend)
+      {
+        ++fStats.Selected;
+        fStats.SelectedBytes += eventBytes + otherBytes;
+      }
+
+      //Next, call analysis plugins
+      for(const auto& ana: fAnaAlgs)
+      {
+        //TODO: Change to directory for this analyzer in case make is called during Analyze.  This might be an indication that I need to rethink
+        //      TFileSentry.
+        fAnaFile->cd(ana.first);
+        ana.second->Analyze();
+      }
+    }
+  }
+
+  void Worker::PrintSchedule(std::ostream& os) const
+  {
+    fScheduler->Print(os);
+  }
+
+  Worker::IOStats& Worker::IOStats::operator +=(const IOStats& other)
+  {
+    Entries += other.Entries;
+    Bytes += other.Bytes;
+    Selected += other.Selected;
+    SelectedBytes += other.SelectedBytes;
+    return *this;
+  }
+
+  Long64_t Worker::Commit(TTree& output)
+  {
+    if(!fOwnsOutput) return 0; //Already wrote directly to the output TTree
+
+    //Point output at the objects in my stage.  This has to happen on every Commit() because other Workers
+    //point output at their own stages too.
+    fOutTree->CopyAddresses(&output);
+    const Long64_t nStaged = fOutTree->GetEntries();
+    for(Long64_t entry = 0; entry < nStaged; ++entry)
+    {
+      fOutTree->GetEntry(entry);
+      output.Fill();
+    }
+    fOutTree->Reset();
+
+    return nStaged;
+  }
+}
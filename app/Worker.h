@@ -0,0 +1,164 @@
+//File: Worker.h
+//Brief: A Worker owns everything one thread needs to process entries from edepsim files: its own TFile handle, its own
+//       plgn::Products, and its own copy of every Reconstructor and Analyzer plugin from the configuration document.
+//       Plugins keep per-event state in member variables, so each thread needs its own plugin instances instead of
+//       sharing them.  NeutronApp creates one Worker per thread and hands each Worker ranges of entries to process.
+//
+//       When a Worker is given an output TDirectory, it writes directly to its own clone of the input TTree in that
+//       directory.  Otherwise, it fills a memory-resident "stage" TTree that NeutronApp empties into the real output
+//       TTree with Commit() so that entries end up in the same order as they were in the input files.
+//
+//       With "reco: output: friend", a Worker writes a slim TTree named RecoEvents instead of a clone of EDepSimEvents.  
+//       RecoEvents has only the Reconstructors' branches plus File, Entry, RunId, and EventId.  It gets an entry for every 
+//       entry processed so that it can be attached to the original EDepSimEvents TTree with AddFriend().  File is the 
+//       number of input files the job read before this one, and Entry is the entry number in that file.  
+//       edep-sim starts EventId over in every file, so NeutronApp indexes RecoEvents on (File, Entry) instead.  
+//
+//       Each entry's TG4Event is read exactly once into a plgn::Event that both the input TTree and the output TTree 
+//       point to.  The rest of the input TTree's branches are only read for entries that will be written out.  
+//
+//       Plugins declare which branches they read.  Every other branch in the input TTree is disabled, and a TTreeCache 
+//       prefetches only the branches that are left.  So, an Analyzer that only looks at Primaries never decompresses 
+//       any TG4HitSegments.  
+//
+//       Reconstructors run in the order a Scheduler picks from the products they Consume() and Produce(). 
+//
+//       If there are any plgn::Filters, only the parts of the TG4Event that Filters need are read first.  Everything else 
+//       is read, reconstructed, and analyzed only for entries that every Filter keeps.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//yaml-cpp includes
+#include "yaml-cpp/yaml.h"
+
+//app includes
+#include "app/Event.h"
+#include "app/Products.h"
+#include "app/Scheduler.h"
+
+//reco includes
+#include "reco/alg/GeoService.h"
+#include "reco/alg/SegmentTable.h"
+
+//truth includes
+#include "alg/TrajectoryIndex.h"
+
+//c++ includes
+#include <memory>
+#include <vector>
+#include <string>
+#include <set>
+
+#ifndef APP_WORKER_H
+#define APP_WORKER_H
+
+class TFile;
+class TTree;
+class TDirectory;
+class TBranch;
+
+namespace util
+{
+  class TFileSentry;
+}
+
+namespace plgn
+{
+  class Reconstructor;
+  class Analyzer;
+}
+
+namespace app
+{
+  class Worker
+  {
+    public:
+      //Number of bytes read from input files.  Lets me check how much I/O each written entry costs.
+      struct IOStats
+      {
+        Long64_t Entries; //Number of entries processed
+        Long64_t Bytes; //Bytes read for all entries, including entries that were written
+        Long64_t Selected; //Number of entries written to the output TTree
+        Long64_t SelectedBytes; //Bytes read for entries written to the output TTree
+
+        IOStats& operator +=(const IOStats& other);
+      };
+
+      //Open firstFile with firstFriend attached and create plugins from the reco and analysis blocks of config.  firstFriend 
+      //may be empty.  If outDir is nullptr, entries are staged in memory until Commit() is called.  Analyzers write to anaFile, 
+      //which may be nullptr if there is no analysis block.
+      Worker(const YAML::Node& config, const std::string& firstFile, const std::string& firstFriend, TDirectory* outDir, 
+             util::TFileSentry* anaFile);
+      virtual ~Worker();
+
+      //Point this Worker at the EDepSimEvents TTree in fileName.  Throws a util::exception if fileName can't be read.
+      //Reconstructors look up volumes in whatever gGeoManager is when this is called.  fileNumber is written to the File 
+      //branch of RecoEvents.  
+      //If friendName is not empty, attach the RecoEvents TTree from friendName to EDepSimEvents so that plugins can 
+      //read objects from an earlier friend-mode job.  friendFileNumber is the File that job wrote for fileName.  Process() 
+      //throws if RecoEvents is missing an entry or its RunId and EventId don't match EDepSimEvents.  
+      void SetFile(const std::string& fileName, const Int_t fileNumber = 0, const std::string& friendName = "", 
+                   const Int_t friendFileNumber = 0);
+
+      //Run all plugins on entries [begin, end) of the current file.
+      void Process(const Long64_t begin, const Long64_t end);
+
+      //Print the order Reconstructors run in
+      void PrintSchedule(std::ostream& os) const;
+
+      //Copy all staged entries into output in the order they were processed and empty the stage.  output must
+      //have been cloned from one of the Workers' Output() TTrees.  Returns the number of entries copied.
+      Long64_t Commit(TTree& output);
+
+      TTree* Output() const { return fOutTree; } //The TTree Reconstructors write to.  nullptr if there is no reco block.
+      bool WritesFriend() const { return fFriend; } //Whether Output() is a RecoEvents friend TTree instead of a clone of EDepSimEvents
+      const IOStats& Stats() const { return fStats; }
+      std::vector<Scheduler::FilterCounts> FilterStats() const { return fScheduler->FilterStats(); }
+      std::vector<Scheduler::RecoCounts> RecoStats() const { return fScheduler->RecoStats(); }
+
+      static constexpr const char* FriendTreeName = "RecoEvents"; //Name of the TTree written in friend mode
+
+    private:
+      void PruneBranches(); //Disable every branch in fInTree that no plugin declared as an input
+      void ReadAlgNames(TFile& file, const TTree& tree); //Remap algorithm IDs in NeutronCands read from tree if file has an AlgNames table
+      void CheckFriend(const Long64_t entry); //Throw if RecoEvents didn't find a row for entry or found one for a different event
+
+      std::string fFileName; //Name of the file this Worker is currently reading
+      Int_t fFileNumber; //Number of input files read before fFileName.  Written to RecoEvents.
+      std::string fFriendName; //Name of the file RecoEvents is attached from.  Empty if there is no friend.
+      Int_t fFriendFileNumber; //File that the job that wrote fFriendName used for fFileName
+      TTree* fFriendTree; //Observer pointer to RecoEvents from fFriendName.  nullptr if there is no friend.
+      TBranch* fFriendRunIdBranch; //RunId in fFriendTree.  EDepSimEvents' Event.RunId has the same name, so read it directly.
+      TBranch* fFriendEventIdBranch; //EventId in fFriendTree
+      Int_t fFriendRunId; //RunId of the RecoEvents row that goes with the current entry
+      Int_t fFriendEventId; //EventId of the RecoEvents row that goes with the current entry
+      std::unique_ptr<TFile> fFile; //This Worker's own handle to the current input file
+      TTree* fInTree; //Observer pointer to the EDepSimEvents TTree in fFile
+      plgn::Products fProducts; //Every product plugins Consume() or Produce()
+      geo::GeoService fGeometry; //Volumes Reconstructors use from the current file's geometry
+      reco::SegmentTable fSegments; //Shared by every plugin that needs TG4HitSegments in local coordinates.  Filled once per event.
+      truth::TrajectoryIndex fTruth; //Shared by every plugin that needs to know which TG4Trajectories came from which.  Filled once per event.
+      plgn::Event fEvent; //The TG4Event fInTree reads into.  Plugins and fOutTree look at the same object.
+      TBranch* fEventBranch; //Branch in fInTree for fEvent
+      std::vector<TBranch*> fFilterBranches; //Enabled parts of fEventBranch that Filters read.  Empty if there are no Filters.
+      std::vector<TBranch*> fLateBranches; //Enabled parts of fEventBranch that are only read if every Filter keeps an entry
+      IOStats fStats; //Bytes read from fInTree
+      std::set<std::string> fInputs; //Union of all plugins' declared inputs plus RunId and EventId.  Empty until plugins have been created.
+
+      bool fFriend; //Write a RecoEvents friend TTree instead of cloning EDepSimEvents?
+      Long64_t fEntry; //Entry number in the current input file.  Written to RecoEvents.
+      Int_t fRunId; //Written to RecoEvents for TTree::BuildIndex()
+      Int_t fEventId; //Written to RecoEvents for TTree::BuildIndex()
+
+      TTree* fOutTree; //Either a clone of fInTree owned by an output file or a memory-resident stage owned by this Worker
+      bool fOwnsOutput; //Whether fOutTree is a stage that I need to delete
+
+      util::TFileSentry* fAnaFile; //Where this Worker's Analyzers write their histograms
+
+      //Plugins are declared last so that they are destroyed before the Products and Event they point to.
+      std::vector<std::pair<std::string, std::unique_ptr<plgn::Reconstructor>>> fRecoAlgs;
+      std::vector<std::pair<std::string, std::unique_ptr<plgn::Analyzer>>> fAnaAlgs;
+      std::unique_ptr<Scheduler> fScheduler; //Runs fRecoAlgs.  Has to be destroyed before them.
+  };
+}
+
+#endif //APP_WORKER_H
@@ -0,0 +1,224 @@
+//File: ColumnsBench.cpp
+//Brief: Compares the size and read speed of MCHits and MCClusters written as std::vectors to the same objects written as
+//       MCHitColumns and MCClusterColumns like a Reconstructor with Compact: true writes them.  Each fake event has tracks
+//       of 1cm MCHits like GridHits makes with a few TrackIDs each and a handful of MCClusters.  Both layouts are written
+//       to TMemFiles with ROOT's default compression and split level, so nothing touches the disk.
+//
+//       Reading is timed 3 ways: std::vectors straight from their branches, columns Expand()ed into std::vectors like
+//       plgn::Products does for a later job, and columns read through their Views without making any MCHits.  Every way
+//       has to add up to the same energy and number of TrackIDs, or this returns non-zero.
+//
+//       Usage: ColumnsBench [nEvents] [nTracks]
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//persistency includes
+#include "persistency/MCHit.h"
+#include "persistency/MCCluster.h"
+#include "persistency/MCHitColumns.h"
+#include "persistency/MCClusterColumns.h"
+
+//ROOT includes
+#include "TMemFile.h"
+#include "TTree.h"
+
+//c++ includes
+#include <vector>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <algorithm>
+
+namespace
+{
+  //Sum of everything that's read so that each way of reading can be checked against the others
+  struct Totals
+  {
+    double Energy;
+    size_t NTrackIDs;
+  };
+
+  //Tracks start near the middle of the detector and take 1cm steps in random directions.  Each step is an MCHit with the
+  //TrackIDs of the particle that made it and sometimes its parent, with duplicates like GridHits leaves them.  Every 20
+  //MCHits in a track make an MCCluster.
+  void MakeEvent(std::mt19937& gen, const size_t nTracks, std::vector<pers::MCHit>& hits, std::vector<pers::MCCluster>& clusters)
+  {
+    std::uniform_real_distribution<double> start(-500., 500.), dir(-1., 1.), energy(0., 2.), coin(0., 1.);
+    std::uniform_int_distribution<int> length(5, 100);
+
+    hits.clear();
+    clusters.clear();
+    for(size_t track = 0; track < nTracks; ++track)
+    {
+      const int trackID = track+1;
+      double x = start(gen), y = start(gen), z = start(gen), t = 10.*coin(gen);
+      const double dx = dir(gen), dy = dir(gen), dz = dir(gen);
+      const int nSteps = length(gen);
+      for(int step = 0; step < nSteps; ++step)
+      {
+        pers::MCHit hit;
+        hit.Energy = energy(gen);
+        hit.Position = TLorentzVector(10.*std::round(x/10.), 10.*std::round(y/10.), 10.*std::round(z/10.), t);
+        hit.Width = 10.;
+        hit.TrackIDs.assign(1+3*coin(gen), trackID);
+        if(coin(gen) < 0.3) hit.TrackIDs.push_back(0); //The parent
+        hits.push_back(hit);
+
+        if(step % 20 == 0)
+        {
+          clusters.emplace_back();
+          clusters.back().Energy = 0.;
+          clusters.back().FirstPosition = hit.Position;
+          clusters.back().XWidth = clusters.back().YWidth = clusters.back().ZWidth = hit.Width;
+        }
+        auto& clust = clusters.back();
+        clust.Energy += hit.Energy;
+        clust.Position = hit.Position;
+        clust.TrackIDs.insert(clust.TrackIDs.end(), hit.TrackIDs.begin(), hit.TrackIDs.end());
+
+        x += 10.*dx;
+        y += 10.*dy;
+        z += 10.*dz;
+        t += 0.05;
+      }
+    }
+  }
+
+  //Only unique TrackIDs survive Fill(), so count them the same way for std::vectors
+  template <class CONTAINER>
+  size_t NUnique(const CONTAINER& trackIDs)
+  {
+    std::vector<int> unique(trackIDs.begin(), trackIDs.end());
+    std::sort(unique.begin(), unique.end());
+    return std::unique(unique.begin(), unique.end()) - unique.begin();
+  }
+
+  template <class HITS, class CLUSTERS>
+  void Add(const HITS& hits, const CLUSTERS& clusters, Totals& totals)
+  {
+    for(size_t hit = 0; hit < hits.size(); ++hit)
+    {
+      totals.Energy += hits[hit].Energy;
+      totals.NTrackIDs += NUnique(hits[hit].TrackIDs);
+    }
+    for(size_t cluster = 0; cluster < clusters.size(); ++cluster)
+    {
+      totals.Energy += clusters[cluster].Energy;
+      totals.NTrackIDs += NUnique(clusters[cluster].TrackIDs);
+    }
+  }
+
+  //Time reading every entry of tree.  read is called after each GetEntry().
+  template <class READ>
+  double TimeRead(TTree& tree, READ&& read)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    for(Long64_t entry = 0; entry < tree.GetEntries(); ++entry)
+    {
+      tree.GetEntry(entry);
+      read();
+    }
+    const std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+    return time.count();
+  }
+
+  bool Agree(const Totals& first, const Totals& second)
+  {
+    return first.NTrackIDs == second.NTrackIDs && std::fabs(first.Energy - second.Energy) < 1e-4*std::fabs(first.Energy);
+  }
+}
+
+int main(const int argc, const char** argv)
+{
+  const size_t nEvents = (argc > 1)?std::stoul(argv[1]):1000;
+  const size_t nTracks = (argc > 2)?std::stoul(argv[2]):10;
+
+  //Write the same events both ways
+  TMemFile vectorFile("ColumnsBenchVectors.root", "RECREATE"), columnsFile("ColumnsBenchColumns.root", "RECREATE");
+  vectorFile.cd();
+  auto vectorTree = new TTree("RecoEvents", "MCHits and MCClusters as std::vectors"); //Owned by vectorFile
+  columnsFile.cd();
+  auto columnsTree = new TTree("RecoEvents", "MCHits and MCClusters as columns"); //Owned by columnsFile
+
+  std::vector<pers::MCHit> hits;
+  std::vector<pers::MCCluster> clusters;
+  auto hitColumns = new pers::MCHitColumns();
+  auto clusterColumns = new pers::MCClusterColumns();
+  vectorTree->Branch("GridNeutronHits", &hits);
+  vectorTree->Branch("MergedClusters", &clusters);
+  columnsTree->Branch("GridNeutronHitsColumns", &hitColumns);
+  columnsTree->Branch("MergedClustersColumns", &clusterColumns);
+
+  std::mt19937 gen(24680);
+  size_t nHits = 0;
+  for(size_t event = 0; event < nEvents; ++event)
+  {
+    MakeEvent(gen, nTracks, hits, clusters);
+    nHits += hits.size();
+    hitColumns->Fill(hits);
+    clusterColumns->Fill(clusters);
+    vectorTree->Fill();
+    columnsTree->Fill();
+  }
+  vectorFile.cd();
+  vectorTree->Write();
+  columnsFile.cd();
+  columnsTree->Write();
+
+  std::cout << nEvents << " events with " << nHits << " MCHits\n"
+            << "Compressed size as std::vectors:   " << vectorTree->GetZipBytes() << " bytes\n"
+            << "Compressed size as columns:        " << columnsTree->GetZipBytes() << " bytes\n"
+            << "Uncompressed size as std::vectors: " << vectorTree->GetTotBytes() << " bytes\n"
+            << "Uncompressed size as columns:      " << columnsTree->GetTotBytes() << " bytes\n"
+            << "Compressed size ratio: " << (double)vectorTree->GetZipBytes()/columnsTree->GetZipBytes() << "\n";
+
+  //Read the std::vectors back like plgn::Products reads a branch that a Reconstructor didn't make
+  std::vector<pers::MCHit>* readHits = nullptr;
+  std::vector<pers::MCCluster>* readClusters = nullptr;
+  vectorTree->SetBranchAddress("GridNeutronHits", &readHits);
+  vectorTree->SetBranchAddress("MergedClusters", &readClusters);
+  Totals vectorTotals{0., 0};
+  const double vectorTime = TimeRead(*vectorTree, [&]() { Add(*readHits, *readClusters, vectorTotals); });
+
+  //Read columns and Expand() them like plgn::Products does when only <branch>Columns is in the input file
+  pers::MCHitColumns* readHitColumns = nullptr;
+  pers::MCClusterColumns* readClusterColumns = nullptr;
+  columnsTree->SetBranchAddress("GridNeutronHitsColumns", &readHitColumns);
+  columnsTree->SetBranchAddress("MergedClustersColumns", &readClusterColumns);
+  std::vector<pers::MCHit> expandedHits;
+  std::vector<pers::MCCluster> expandedClusters;
+  Totals expandTotals{0., 0};
+  const double expandTime = TimeRead(*columnsTree, [&]()
+                                                   {
+                                                     readHitColumns->Expand(expandedHits);
+                                                     readClusterColumns->Expand(expandedClusters);
+                                                     Add(expandedHits, expandedClusters, expandTotals);
+                                                   });
+
+  //Read columns through their Views
+  Totals viewTotals{0., 0};
+  const double viewTime = TimeRead(*columnsTree, [&]() { Add(*readHitColumns, *readClusterColumns, viewTotals); });
+
+  std::cout << "Reading std::vectors:            " << vectorTime << " ms\n"
+            << "Reading and Expand()ing columns: " << expandTime << " ms\n"
+            << "Reading columns as Views:        " << viewTime << " ms\n";
+
+  vectorTree->ResetBranchAddresses();
+  columnsTree->ResetBranchAddresses();
+  delete readHits;
+  delete readClusters;
+  delete readHitColumns;
+  delete readClusterColumns;
+  delete hitColumns;
+  delete clusterColumns;
+
+  if(!Agree(vectorTotals, expandTotals) || !Agree(vectorTotals, viewTotals))
+  {
+    std::cerr << "std::vectors and columns disagree!  std::vectors had " << vectorTotals.Energy << " MeV and " << vectorTotals.NTrackIDs
+              << " TrackIDs, Expand()ed columns had " << expandTotals.Energy << " MeV and " << expandTotals.NTrackIDs << " TrackIDs, "
+              << "and Views had " << viewTotals.Energy << " MeV and " << viewTotals.NTrackIDs << " TrackIDs.\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,151 @@
+//File: VoxelMapBench.cpp
+//Brief: Times reco::VoxelMap against the std::map<GridHits::Triple, GridHits::HitData> that GridHits used to fill.  Each fake
+//       event is a few straight tracks through 1cm cubes like GridHits::MakeHitData() makes.  Every track step looks up
+//       its cube with operator[], and then every cube looks for its 26 neighbors like GridNeutronHits used to.  The std::map
+//       is made fresh for every event like it was in DoReconstruct(), and the VoxelMap is cleared like a plugin's member.
+//       Both containers have to end up with the same energy and the same number of neighbors, or this returns non-zero.
+//
+//       Usage: VoxelMapBench [nEvents] [nTracks]
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//edepsim includes
+#include "TG4HitSegment.h"
+
+//reco includes
+#include "reco/alg/GridHits.h"
+#include "reco/alg/VoxelMap.h"
+
+//c++ includes
+#include <map>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <cmath>
+
+namespace
+{
+  using Triple = reco::GridHits::Triple;
+  using HitData = reco::GridHits::HitData;
+
+  //One cube that a track step enters and the energy it deposits there
+  struct Step
+  {
+    Triple Pos;
+    double Energy;
+  };
+
+  //Tracks start near the middle of a 3m detector and go in random directions
+  std::vector<std::vector<Step>> MakeEvents(const size_t nEvents, const size_t nTracks)
+  {
+    std::mt19937 gen(12345);
+    std::uniform_real_distribution<double> start(-50., 50.), dir(-1., 1.), energy(0., 2.);
+    std::uniform_int_distribution<int> length(5, 200);
+
+    std::vector<std::vector<Step>> events(nEvents);
+    for(auto& event: events)
+    {
+      for(size_t track = 0; track < nTracks; ++track)
+      {
+        double x = start(gen), y = start(gen), z = start(gen);
+        const double dx = dir(gen), dy = dir(gen), dz = dir(gen);
+        const int nSteps = length(gen);
+        for(int step = 0; step < nSteps; ++step)
+        {
+          event.push_back(Step{Triple(std::lrint(x), std::lrint(y), std::lrint(z)), energy(gen)});
+          x += 0.5*dx;
+          y += 0.5*dy;
+          z += 0.5*dz;
+        }
+      }
+    }
+    return events;
+  }
+
+  //Sum up each step's energy in its cube, then count how many cubes are next to each cube.  Returns the number of 
+  //neighbors so that both containers can be checked against each other.
+  template <class FILL, class FIND>
+  size_t Process(const std::vector<Step>& event, FILL&& fill, FIND&& find, const std::vector<Triple>& cubes)
+  {
+    size_t nNeighbors = 0;
+    for(const auto& step: event) fill(step);
+    for(const auto& cube: cubes)
+    {
+      for(int x = -1; x <= 1; ++x)
+      {
+        for(int y = -1; y <= 1; ++y)
+        {
+          for(int z = -1; z <= 1; ++z)
+          {
+            if(x == 0 && y == 0 && z == 0) continue;
+            if(find(Triple(cube.First+x, cube.Second+y, cube.Third+z))) ++nNeighbors;
+          }
+        }
+      }
+    }
+    return nNeighbors;
+  }
+}
+
+int main(const int argc, const char** argv)
+{
+  const size_t nEvents = (argc > 1)?std::stoul(argv[1]):1000;
+  const size_t nTracks = (argc > 2)?std::stoul(argv[2]):10;
+  const auto events = MakeEvents(nEvents, nTracks);
+
+  //The cubes each event touched, in the order the std::map would iterate over them
+  std::vector<std::vector<Triple>> cubes;
+  for(const auto& event: events)
+  {
+    std::map<Triple, HitData> unique;
+    for(const auto& step: event) unique[step.Pos];
+    cubes.emplace_back();
+    for(const auto& pair: unique) cubes.back().push_back(pair.first);
+  }
+
+  size_t nSteps = 0;
+  for(const auto& event: events) nSteps += event.size();
+
+  //Old way
+  double mapEnergy = 0.;
+  size_t mapNeighbors = 0;
+  const auto mapStart = std::chrono::steady_clock::now();
+  for(size_t event = 0; event < events.size(); ++event)
+  {
+    std::map<Triple, HitData> hits;
+    mapNeighbors += Process(events[event],
+                            [&hits](const Step& step) { auto& hit = hits[step.Pos]; hit.Energy += step.Energy; ++hit.NContrib; },
+                            [&hits](const Triple& pos) { return hits.find(pos) != hits.end(); }, cubes[event]);
+    for(const auto& hit: hits) mapEnergy += hit.second.Energy;
+  }
+  const std::chrono::duration<double, std::milli> mapTime = std::chrono::steady_clock::now() - mapStart;
+
+  //New way
+  double voxelEnergy = 0.;
+  size_t voxelNeighbors = 0;
+  reco::GridHits::HitMap hits;
+  const auto voxelStart = std::chrono::steady_clock::now();
+  for(size_t event = 0; event < events.size(); ++event)
+  {
+    hits.clear();
+    voxelNeighbors += Process(events[event],
+                              [&hits](const Step& step) { auto& hit = hits[step.Pos]; hit.Energy += step.Energy; ++hit.NContrib; },
+                              [&hits](const Triple& pos) { return hits.find(pos) != nullptr; }, cubes[event]);
+    for(const auto& hit: hits) voxelEnergy += hit.second.Energy;
+  }
+  const std::chrono::duration<double, std::milli> voxelTime = std::chrono::steady_clock::now() - voxelStart;
+
+  std::cout << nEvents << " events with " << nSteps << " track steps\n"
+            << "std::map<Triple, HitData>: " << mapTime.count() << " ms\n"
+            << "VoxelMap<Triple, HitData>: " << voxelTime.count() << " ms\n"
+            << "Speedup: " << mapTime.count()/voxelTime.count() << "\n";
+
+  if(mapNeighbors != voxelNeighbors || std::fabs(mapEnergy - voxelEnergy) > 1e-6*mapEnergy)
+  {
+    std::cerr << "std::map and VoxelMap disagree!  std::map found " << mapNeighbors << " neighbors and " << mapEnergy << " MeV, but VoxelMap "
+              << "found " << voxelNeighbors << " neighbors and " << voxelEnergy << " MeV.\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,60 @@
+//File: AlgNames.cpp
+//Brief: The process-wide table of algorithm names that NeutronCands refer to by ID.  See AlgNames.h.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//local includes
+#include "AlgNames.h"
+
+//c++ includes
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+namespace
+{
+  //There are only ever a handful of algorithm names, so searching a std::vector is faster than a std::map.
+  std::vector<std::string> gNames;
+  std::mutex gMutex;
+
+  pers::AlgNames::ID_t Intern(const std::string& name)
+  {
+    const auto found = std::find(gNames.begin(), gNames.end(), name);
+    if(found != gNames.end()) return found - gNames.begin();
+
+    if(gNames.size() > std::numeric_limits<pers::AlgNames::ID_t>::max()) throw std::length_error("Too many algorithm names for pers::AlgNames");
+    gNames.push_back(name);
+    return gNames.size()-1;
+  }
+}
+
+namespace pers
+{
+  constexpr const char* AlgNames::ObjectName;
+
+  AlgNames::ID_t AlgNames::ID(const std::string& name)
+  {
+    std::lock_guard<std::mutex> lock(gMutex);
+    return Intern(name);
+  }
+
+  std::string AlgNames::Name(const ID_t id)
+  {
+    std::lock_guard<std::mutex> lock(gMutex);
+    return gNames.at(id);
+  }
+
+  std::vector<std::string> AlgNames::Names()
+  {
+    std::lock_guard<std::mutex> lock(gMutex);
+    return gNames;
+  }
+
+  std::vector<AlgNames::ID_t> AlgNames::Remap(const std::vector<std::string>& names)
+  {
+    std::lock_guard<std::mutex> lock(gMutex);
+    std::vector<ID_t> ids;
+    for(const auto& name: names) ids.push_back(Intern(name));
+    return ids;
+  }
+}
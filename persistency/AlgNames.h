@@ -0,0 +1,43 @@
+//File: AlgNames.h
+//Brief: AlgNames turns the names of algorithms that produce MCClusters into small integer IDs that every NeutronCand can
+//       store instead of a std::string per cluster.  There is one table per process.  Every Reconstructor asks for its
+//       ID when it is constructed, and NeutronApp writes the table to each output file as a std::vector<std::string>
+//       named AlgNames.  A NeutronCand's ClusterAlgs[i] is the index of an algorithm's name in that table.
+//
+//       Files written by other jobs might have given IDs in a different order.  Remap() turns a file's table into
+//       the IDs its NeutronCands' ClusterAlgs mean in this process.
+//
+//       Safe to use from every Worker's thread at the same time.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//c++ includes
+#include <string>
+#include <vector>
+
+#ifndef PERS_ALGNAMES_H
+#define PERS_ALGNAMES_H
+
+namespace pers
+{
+  class AlgNames
+  {
+    public:
+      using ID_t = unsigned short;
+      static constexpr const char* ObjectName = "AlgNames"; //Name of the table in each output file
+
+      //ID for name.  Names are given IDs in the order they are first seen.
+      static ID_t ID(const std::string& name);
+
+      //Name of the algorithm with ID id.  Throws std::out_of_range if no algorithm has that ID.
+      static std::string Name(const ID_t id);
+
+      //Copy of every name seen so far.  Names()[id] is Name(id).
+      static std::vector<std::string> Names();
+
+      //Add the table from a file that was written by another job.  Returns the ID in this process of each name in names, 
+      //so an ID id read from that file means Remap(names)[id] here.
+      static std::vector<ID_t> Remap(const std::vector<std::string>& names);
+  };
+}
+
+#endif //PERS_ALGNAMES_H
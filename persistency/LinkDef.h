@@ -1,6 +1,8 @@
 #ifdef __CINT__
 #include "MCHit.h"
 #include "MCCluster.h"
+#include "MCHitColumns.h"
+#include "MCClusterColumns.h"
 
 #pragma link C++ class pers::MCHit+;
 #pragma link C++ class std::vector<pers::MCHit>+;
@@ -8,7 +10,29 @@
 #pragma link C++ class pers::MCCluster+;
 #pragma link C++ class std::vector<pers::MCCluster>+;
 
+#pragma link C++ class pers::MCHitColumns+;
+#pragma link C++ class pers::MCClusterColumns+;
+
 #pragma link C++ class pers::NeutronCand+;
 #pragma link C++ class std::vector<pers::NeutronCand>+;
 
+//Version 1 NeutronCands kept their TrackIDs in a std::set and their clusters in a std::map from algorithm name to indices.
+//Read them into version 2's flat arrays.  Algorithm names get IDs from this process's pers::AlgNames table.
+#pragma read sourceClass="pers::NeutronCand" version="[1]" targetClass="pers::NeutronCand" \
+             source="std::set<int> TrackIDs; std::map<std::string, std::vector<size_t>> ClusterAlgToIndices" \
+             target="TrackIDs, ClusterAlgs, ClusterIndices" include="AlgNames.h" \
+             code="{ TrackIDs.assign(onfile.TrackIDs.begin(), onfile.TrackIDs.end()); \
+                     ClusterAlgs.clear(); \
+                     ClusterIndices.clear(); \
+                     for(const auto& alg: onfile.ClusterAlgToIndices) \
+                     { \
+                       const auto id = pers::AlgNames::ID(alg.first); \
+                       for(const auto index: alg.second) \
+                       { \
+                         ClusterAlgs.push_back(id); \
+                         ClusterIndices.push_back(index); \
+                       } \
+                     } \
+                   }"
+
 #endif
@@ -0,0 +1,68 @@
+//File: MCClusterColumns.cpp
+//Brief: Conversions between MCClusterColumns and std::vector<MCCluster>.  Also registers MCClusterColumns with ROOT.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//local includes
+#include "MCClusterColumns.h"
+
+//c++ includes
+#include <algorithm>
+
+namespace pers
+{
+  //ClassImp(MCClusterColumns);
+
+  MCClusterColumns::~MCClusterColumns()
+  {
+  }
+
+  void MCClusterColumns::clear()
+  {
+    for(auto column: {&X, &Y, &Z, &T, &FirstX, &FirstY, &FirstZ, &FirstT, &Energy, &XWidth, &YWidth, &ZWidth}) column->clear();
+    TrackIDOffsets.assign(1, 0);
+    TrackIDs.clear();
+  }
+
+  void MCClusterColumns::Fill(const std::vector<MCCluster>& clusters)
+  {
+    clear();
+    for(const auto& clust: clusters)
+    {
+      X.push_back(clust.Position.X());
+      Y.push_back(clust.Position.Y());
+      Z.push_back(clust.Position.Z());
+      T.push_back(clust.Position.T());
+      FirstX.push_back(clust.FirstPosition.X());
+      FirstY.push_back(clust.FirstPosition.Y());
+      FirstZ.push_back(clust.FirstPosition.Z());
+      FirstT.push_back(clust.FirstPosition.T());
+      Energy.push_back(clust.Energy);
+      XWidth.push_back(clust.XWidth);
+      YWidth.push_back(clust.YWidth);
+      ZWidth.push_back(clust.ZWidth);
+
+      //Each TrackID only once
+      const auto begin = TrackIDs.insert(TrackIDs.end(), clust.TrackIDs.begin(), clust.TrackIDs.end());
+      std::sort(begin, TrackIDs.end());
+      TrackIDs.erase(std::unique(begin, TrackIDs.end()), TrackIDs.end());
+      TrackIDOffsets.push_back(TrackIDs.size());
+    }
+  }
+
+  void MCClusterColumns::Expand(std::vector<MCCluster>& clusters) const
+  {
+    clusters.resize(size());
+    for(size_t index = 0; index < size(); ++index)
+    {
+      const auto view = (*this)[index];
+      auto& clust = clusters[index];
+      clust.Energy = view.Energy;
+      clust.TrackIDs.assign(view.TrackIDs.begin(), view.TrackIDs.end());
+      clust.Position = view.Position;
+      clust.FirstPosition = view.FirstPosition;
+      clust.XWidth = view.XWidth;
+      clust.YWidth = view.YWidth;
+      clust.ZWidth = view.ZWidth;
+    }
+  }
+}
@@ -0,0 +1,71 @@
+//File: MCClusterColumns.h
+//Brief: MCClusterColumns holds all of one event's MCClusters from one algorithm as columns of numbers like
+//       MCHitColumns does for MCHits.  Positions, times, energies, and widths are floats, and each MCCluster's unique
+//       TrackIDs are stored in one flat std::vector with offsets.  When it is written with the default split level,
+//       every column becomes its own TBranch.
+//
+//       operator[] returns an MCClusterColumns::View whose members have the same names as MCCluster's.  Fill() and
+//       Expand() convert to and from std::vector<MCCluster>.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//local includes
+#include "MCCluster.h"
+#include "TrackIDRange.h"
+
+//ROOT includes
+#include <TObject.h>
+#include <TLorentzVector.h>
+
+//c++ includes
+#include <vector>
+
+#ifndef PERS_MCCLUSTERCOLUMNS_H
+#define PERS_MCCLUSTERCOLUMNS_H
+
+namespace pers
+{
+  class MCClusterColumns: public TObject
+  {
+    public:
+      //Looks like an MCCluster
+      struct View
+      {
+        double Energy;
+        TrackIDRange TrackIDs;
+        TLorentzVector Position;
+        TLorentzVector FirstPosition;
+        float XWidth;
+        float YWidth;
+        float ZWidth;
+      };
+
+      MCClusterColumns(void): X(), Y(), Z(), T(), FirstX(), FirstY(), FirstZ(), FirstT(), Energy(), XWidth(), YWidth(), ZWidth(),
+                              TrackIDOffsets(1, 0), TrackIDs() {}
+      virtual ~MCClusterColumns(); //This needs to be defined in the .cpp file so that I can call ClassImp(?)
+
+      size_t size() const { return Energy.size(); }
+      bool empty() const { return Energy.empty(); }
+      View operator [](const size_t index) const
+      {
+        return View{Energy[index], TrackIDRange(TrackIDs.data() + TrackIDOffsets[index], TrackIDs.data() + TrackIDOffsets[index+1]),
+                    TLorentzVector(X[index], Y[index], Z[index], T[index]), 
+                    TLorentzVector(FirstX[index], FirstY[index], FirstZ[index], FirstT[index]),
+                    XWidth[index], YWidth[index], ZWidth[index]};
+      }
+
+      void clear(); //Remove all MCClusters but keep memory
+      void Fill(const std::vector<MCCluster>& clusters); //Replace everything with clusters
+      void Expand(std::vector<MCCluster>& clusters) const; //Replace everything in clusters with the MCClusters stored here
+
+      std::vector<float> X, Y, Z, T; //Energy-weighted center of each MCCluster
+      std::vector<float> FirstX, FirstY, FirstZ, FirstT; //Position of the "first" MCHit in each MCCluster
+      std::vector<float> Energy; //Energy deposited in each MCCluster
+      std::vector<float> XWidth, YWidth, ZWidth; //Size of each MCCluster
+      std::vector<unsigned int> TrackIDOffsets; //MCCluster i's TrackIDs are TrackIDs[TrackIDOffsets[i], TrackIDOffsets[i+1])
+      std::vector<int> TrackIDs; //Unique TrackIDs of every MCCluster, one after the other
+
+      ClassDef(MCClusterColumns, 1);
+  };
+}
+
+#endif //PERS_MCCLUSTERCOLUMNS_H
@@ -0,0 +1,71 @@
+//File: MCHitColumns.cpp
+//Brief: Conversions between MCHitColumns and std::vector<MCHit>.  Also registers MCHitColumns with ROOT.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//local includes
+#include "MCHitColumns.h"
+
+//c++ includes
+#include <algorithm>
+
+namespace pers
+{
+  //ClassImp(MCHitColumns);
+
+  MCHitColumns::~MCHitColumns()
+  {
+  }
+
+  void MCHitColumns::clear()
+  {
+    X.clear();
+    Y.clear();
+    Z.clear();
+    T.clear();
+    Energy.clear();
+    Width = 0.;
+    Widths.clear();
+    TrackIDOffsets.assign(1, 0);
+    TrackIDs.clear();
+  }
+
+  void MCHitColumns::Fill(const std::vector<MCHit>& hits)
+  {
+    clear();
+    bool sameWidth = true;
+    if(!hits.empty()) Width = hits.front().Width;
+
+    for(const auto& hit: hits)
+    {
+      X.push_back(hit.Position.X());
+      Y.push_back(hit.Position.Y());
+      Z.push_back(hit.Position.Z());
+      T.push_back(hit.Position.T());
+      Energy.push_back(hit.Energy);
+      Widths.push_back(hit.Width);
+      sameWidth = sameWidth && ((float)hit.Width == Width);
+
+      //Each TrackID only once
+      const auto begin = TrackIDs.insert(TrackIDs.end(), hit.TrackIDs.begin(), hit.TrackIDs.end());
+      std::sort(begin, TrackIDs.end());
+      TrackIDs.erase(std::unique(begin, TrackIDs.end()), TrackIDs.end());
+      TrackIDOffsets.push_back(TrackIDs.size());
+    }
+
+    if(sameWidth) Widths.clear();
+  }
+
+  void MCHitColumns::Expand(std::vector<MCHit>& hits) const
+  {
+    hits.resize(size());
+    for(size_t index = 0; index < size(); ++index)
+    {
+      const auto view = (*this)[index];
+      auto& hit = hits[index];
+      hit.Energy = view.Energy;
+      hit.Position = view.Position;
+      hit.Width = view.Width;
+      hit.TrackIDs.assign(view.TrackIDs.begin(), view.TrackIDs.end());
+    }
+  }
+}
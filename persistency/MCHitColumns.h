@@ -0,0 +1,68 @@
+//File: MCHitColumns.h
+//Brief: MCHitColumns holds all of one event's MCHits from one algorithm as columns of numbers.  A std::vector<MCHit>
+//       stores a TObject, a TLorentzVector (which holds its own TObject and TVector3), a double Width, and a
+//       std::vector<int> of TrackIDs with duplicates for every MCHit.  That overhead is most of the size of a reco file.
+//       MCHitColumns instead stores float x, y, z, t, and energy columns, one Width for the whole branch when every
+//       MCHit has the same Width, and each MCHit's unique TrackIDs in one flat std::vector with offsets.  When it is
+//       written with the default split level, every column becomes its own TBranch.
+//
+//       operator[] returns an MCHitColumns::View whose members have the same names as MCHit's, so code that reads
+//       hit.Energy, hit.Position, hit.Width, and hit.TrackIDs works on either one.  Fill() and Expand() convert to and
+//       from std::vector<MCHit>.  Expand()ed MCHits have float precision and sorted, unique TrackIDs.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//local includes
+#include "MCHit.h"
+#include "TrackIDRange.h"
+
+//ROOT includes
+#include <TObject.h>
+#include <TLorentzVector.h>
+
+//c++ includes
+#include <vector>
+
+#ifndef PERS_MCHITCOLUMNS_H
+#define PERS_MCHITCOLUMNS_H
+
+namespace pers
+{
+  class MCHitColumns: public TObject
+  {
+    public:
+      //Looks like an MCHit
+      struct View
+      {
+        double Energy;
+        TLorentzVector Position;
+        double Width;
+        TrackIDRange TrackIDs;
+      };
+
+      MCHitColumns(void): X(), Y(), Z(), T(), Energy(), Width(0.), Widths(), TrackIDOffsets(1, 0), TrackIDs() {}
+      virtual ~MCHitColumns(); //This needs to be defined in the .cpp file so that I can call ClassImp(?)
+
+      size_t size() const { return Energy.size(); }
+      bool empty() const { return Energy.empty(); }
+      View operator [](const size_t index) const
+      {
+        return View{Energy[index], TLorentzVector(X[index], Y[index], Z[index], T[index]), Widths.empty()?Width:Widths[index],
+                    TrackIDRange(TrackIDs.data() + TrackIDOffsets[index], TrackIDs.data() + TrackIDOffsets[index+1])};
+      }
+
+      void clear(); //Remove all MCHits but keep memory
+      void Fill(const std::vector<MCHit>& hits); //Replace everything with hits
+      void Expand(std::vector<MCHit>& hits) const; //Replace everything in hits with the MCHits stored here
+
+      std::vector<float> X, Y, Z, T; //Position of each MCHit
+      std::vector<float> Energy; //Energy deposited in each MCHit
+      float Width; //Width of every MCHit if Widths is empty
+      std::vector<float> Widths; //Width of each MCHit.  Only filled if MCHits have different Widths.
+      std::vector<unsigned int> TrackIDOffsets; //MCHit i's TrackIDs are TrackIDs[TrackIDOffsets[i], TrackIDOffsets[i+1])
+      std::vector<int> TrackIDs; //Unique TrackIDs of every MCHit, one after the other
+
+      ClassDef(MCHitColumns, 1);
+  };
+}
+
+#endif //PERS_MCHITCOLUMNS_H
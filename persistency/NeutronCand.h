@@ -2,6 +2,11 @@
 //Brief: A NeutronCand is a group of MCClusters that I hypothesize are from the same (FS?) neutron.  It has a guess at neutron energy from Time Of Flight, the sum of 
 //       deposited energy from its' clusters, the indices of the clusters it contains for each clustering algorithm used, and the list of unique true particles that 
 //       contributed to its' clusters.  I might add a direction eventually, especially if this is a candidate for a FS neutron.  
+//
+//       Version 2 stores its clusters as two flat arrays instead of a std::map from algorithm name to indices.  ClusterAlgs[i] is
+//       the ID of the algorithm that made cluster i in pers::AlgNames, and ClusterIndices[i] is that cluster's index in that
+//       algorithm's branch.  TrackIDs is a sorted std::vector instead of a std::set.  Version 1 files are converted when they are 
+//       read by a rule in LinkDef.h.
 //Author: Andrew Olivier aolivier@ur.rochester.edu
 
 //ROOT includes
@@ -9,8 +14,9 @@
 #include <TLorentzVector.h>
 
 //c++ includes
-#include <set>
-#include <map>
+#include <vector>
+#include <algorithm>
+#include <iterator>
 
 #ifndef PERS_NEUTRONCAND_H
 #define PERS_NEUTRONCAND_H
@@ -33,14 +39,30 @@ namespace pers
       TLorentzVector Start; //All in mm like edep-sim
 
       //TrackIDs that contributed to this NeutronCand.  
-      std::set<int> TrackIDs; //TODO: Do I need this if I can backtrack to MCClusters?   
+      std::vector<int> TrackIDs; //Sorted with no duplicates.  TODO: Do I need this if I can backtrack to MCClusters?   
 
-      //Indices of MCClusters in this neutron candidate
-      std::map<std::string, std::vector<size_t>> ClusterAlgToIndices; //TODO: Turn these indices into clusters/links/iterators?  I could do this like what I think ART 
-                                                                      //      does and store everything in a Ptr class template that has a unique index, but I'd rather 
-                                                                      //      my file format stay as close to edep-sim as possible.  
+      //MCClusters in this neutron candidate.  Both have the same size.
+      std::vector<unsigned short> ClusterAlgs; //pers::AlgNames ID of the algorithm that made each MCCluster
+      std::vector<unsigned int> ClusterIndices; //Index of each MCCluster in its algorithm's branch
 
-      ClassDef(NeutronCand, 1);
+      //Add the MCCluster at index in the branch from the algorithm with ID alg
+      void AddCluster(const unsigned short alg, const unsigned int index)
+      {
+        ClusterAlgs.push_back(alg);
+        ClusterIndices.push_back(index);
+      }
+
+      //Add every TrackID from begin to end that isn't already in TrackIDs.  Keeps TrackIDs sorted.
+      template <class ITERATOR>
+      void AddTrackIDs(const ITERATOR begin, const ITERATOR end)
+      {
+        const auto oldEnd = TrackIDs.insert(TrackIDs.end(), begin, end);
+        std::sort(oldEnd, TrackIDs.end());
+        std::inplace_merge(TrackIDs.begin(), oldEnd, TrackIDs.end());
+        TrackIDs.erase(std::unique(TrackIDs.begin(), TrackIDs.end()), TrackIDs.end());
+      }
+
+      ClassDef(NeutronCand, 2);
   };
 }
 
@@ -0,0 +1,33 @@
+//File: TrackIDRange.h
+//Brief: A TrackIDRange looks at the TrackIDs of one object in a columnar persistency class like MCHitColumns.  Those
+//       classes keep every object's TrackIDs in one flat std::vector, so a TrackIDRange is just 2 pointers into it.
+//       It has begin(), end(), size(), and operator[] like the std::vector<int> in MCHit, so code that loops over
+//       TrackIDs doesn't have to change.  Never written to a file.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//c++ includes
+#include <cstddef>
+
+#ifndef PERS_TRACKIDRANGE_H
+#define PERS_TRACKIDRANGE_H
+
+namespace pers
+{
+  class TrackIDRange
+  {
+    public:
+      TrackIDRange(const int* begin, const int* end): fBegin(begin), fEnd(end) {}
+
+      const int* begin() const { return fBegin; }
+      const int* end() const { return fEnd; }
+      size_t size() const { return fEnd - fBegin; }
+      bool empty() const { return fBegin == fEnd; }
+      int operator [](const size_t index) const { return fBegin[index]; }
+
+    private:
+      const int* fBegin; //First TrackID
+      const int* fEnd; //One past the last TrackID
+  };
+}
+
+#endif //PERS_TRACKIDRANGE_H
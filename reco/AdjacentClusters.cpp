@@ -6,53 +6,61 @@
 #include "app/Factory.cpp"
 #include "reco/AdjacentClusters.h"
 
+//c++ includes
+#include <cmath>
+
 namespace reco
 {
-  AdjacentClusters::AdjacentClusters(const plgn::Reconstructor::Config& config): plgn::Reconstructor(config), fClusters(), fHits(*(config.Input), "NeutronHits")
+  AdjacentClusters::AdjacentClusters(const plgn::Reconstructor::Config& config): plgn::Reconstructor(config), fClusters(), 
+                                                                                 fHits(Consume<pers::MCHit>(config.Options["HitAlg"].as<std::string>())),
+                                                                                 fRadius(config.Options["Radius"].as<double>()), 
+                                                                                 fClusterAlg(fRadius+0.01), fOutputOf()
   {
-    config.Output->Branch("AdjacentClusters", &fClusters);
+    Produce("AdjacentClusters", fClusters);
   }
 
   bool AdjacentClusters::DoReconstruct()
   {
     fClusters.clear(); //Remove clusters from previous events!
 
-    //Make my own copy of the vector of hits as a std::list so I can remove the ones I use
-    std::list<pers::MCHit> hits(fHits.begin(), fHits.end());
+    const size_t nHits = fHits.size();
+    if(nHits == 0) return false;
+
+    const size_t nClusters = fClusterAlg.Group(fHits);
+    const auto& clusterOf = fClusterAlg.ClusterOf();
 
-    while(hits.size() > 0)
+    //Each cluster's seed is its first MCHit.  Position is the seed's position, and each width is the farthest any MCHit
+    //is from the seed or the seed's Width, whichever is bigger.
+    fOutputOf.assign(nClusters, nClusters);
+    for(size_t hitIndex = 0; hitIndex < nHits; ++hitIndex)
     {
-      const auto& seed = *(hits.begin());
-      pers::MCCluster clust;
-      clust.Position = seed.Position;
-      clust.XWidth = seed.Width;
-      clust.YWidth = seed.Width;
-      clust.ZWidth = seed.Width;
-
-      //Make MCClusters from all MCHits that are indirectly adjacent to seed
-      hits.remove_if([&seed, &clust](const auto& hit)
-                     {
-                       const auto diff = clust.Position-hit.Position;
-                       const double adjacent = 5.+0.01;
-                       if(std::fabs(diff.X()) < adjacent*seed.Width && std::fabs(diff.Y()) < adjacent*seed.Width && std::fabs(diff.Z()) < adjacent*seed.Width)
-                       {
-                         clust.Energy += hit.Energy;
-                         clust.TrackIDs.insert(clust.TrackIDs.end(), hit.TrackIDs.begin(), hit.TrackIDs.end());
-                         
-                         //Update cluster size
-                         if(std::fabs(diff.X()) > clust.XWidth) clust.XWidth = std::fabs(diff.X());
-                         if(std::fabs(diff.Y()) > clust.YWidth) clust.YWidth = std::fabs(diff.Y());
-                         if(std::fabs(diff.Z()) > clust.ZWidth) clust.ZWidth = std::fabs(diff.Z()); 
-
-                         return true;
-                       }
-                       return false;
-                     });
-      fClusters.push_back(clust);
+      const auto& hit = fHits[hitIndex];
+      auto& output = fOutputOf[clusterOf[hitIndex]];
+      if(output == nClusters)
+      {
+        output = fClusters.size();
+        pers::MCCluster clust;
+        clust.Energy = 0.;
+        clust.Position = hit.Position;
+        clust.XWidth = hit.Width;
+        clust.YWidth = hit.Width;
+        clust.ZWidth = hit.Width;
+        fClusters.push_back(clust);
+      }
+
+      auto& clust = fClusters[output];
+      clust.Energy += hit.Energy;
+      clust.TrackIDs.insert(clust.TrackIDs.end(), hit.TrackIDs.begin(), hit.TrackIDs.end());
+
+      //Update cluster size
+      const auto fromSeed = clust.Position-hit.Position;
+      if(std::fabs(fromSeed.X()) > clust.XWidth) clust.XWidth = std::fabs(fromSeed.X());
+      if(std::fabs(fromSeed.Y()) > clust.YWidth) clust.YWidth = std::fabs(fromSeed.Y());
+      if(std::fabs(fromSeed.Z()) > clust.ZWidth) clust.ZWidth = std::fabs(fromSeed.Z());
     }
 
     return !(fClusters.empty());
   }
+
   REGISTER_PLUGIN(AdjacentClusters, plgn::Reconstructor)
 }
-
@@ -1,15 +1,12 @@
 //File: AdjacentClusters.h
-//Brief: A Reconstructor that reads in a TG4Event from edepsim and creates MCHits from energy deposits that were 
-//       created by ancestors of FS neutrons. 
+//Brief: A Reconstructor that groups MCHits into MCClusters of MCHits that are connected by chains of adjacent MCHits.
 //Author: Andrew Olivier aolivier@ur.rochester.edu
 
 //EdepNeutrons includes
 #include "reco/Reconstructor.h"
 #include "persistency/MCHit.h"
 #include "persistency/MCCluster.h"
-
-//ROOT includes
-#include "TTreeReaderArray.h"
+#include "reco/alg/HitClusterer.h"
 
 #ifndef RECO_ADJACENTCLUSTERS_H
 #define RECO_ADJACENTCLUSTERS_H
@@ -29,7 +26,15 @@ namespace reco
       std::vector<pers::MCCluster> fClusters;
 
       //Location from which MCHits will be read
-      TTreeReaderArray<pers::MCHit> fHits;
+      plgn::Handle<pers::MCHit> fHits;
+
+      double fRadius; //MCHits closer than this many widths along every axis are adjacent
+
+    private:
+      HitClusterer fClusterAlg; //Finds which MCHits are connected by chains of adjacent MCHits
+
+      //Scratch space kept between events so that it doesn't allocate memory every time
+      std::vector<size_t> fOutputOf; //Index in fClusters of each of fClusterAlg's clusters.  Past the end until its seed is found.
   };
 }
 
@@ -18,8 +18,9 @@
 
 namespace reco
 {
-  CCQEChargedFSFilter::CCQEChargedFSFilter(const plgn::Reconstructor::Config& config): plgn::Reconstructor(config)
+  CCQEChargedFSFilter::CCQEChargedFSFilter(const plgn::Reconstructor::Config& config): plgn::Filter(config)
   {
+    DeclareInput("Primaries"); //Only Primaries are read before this Filter decides whether to keep an event
   }
 
   bool CCQEChargedFSFilter::DoReconstruct()
@@ -27,7 +28,7 @@ namespace reco
     //TODO: Write a "Reconstructor" filter for any FS topology.  Probably powered by std::regex.  On a very tight deadline, so 
     //      keeping this as simple as possible for now.  
     std::multiset<std::string> mult;
-    for(const auto& vert: fEvent->Primaries)
+    for(const auto& vert: fEvent.Primaries())
     {
       for(const auto& part: vert.Particles)
       {
@@ -32,19 +32,20 @@
 namespace reco
 {
   CandFromCluster::CandFromCluster(const plgn::Reconstructor::Config& config): plgn::Reconstructor(config), fCands(), 
-                                                                       fClusters(*(config.Input), 
-                                                                                 config.Options["ClusterAlg"].as<std::string>().c_str()), 
+                                                                       fClusters(Consume<pers::MCCluster>(config.Options["ClusterAlg"].as<std::string>())), 
                                                                        fClusterAlgName(config.Options["ClusterAlg"].as<std::string>().c_str()), 
+                                                                       fClusterAlgID(pers::AlgNames::ID(fClusterAlgName)),
                                                                        fTimeRes(config.Options["TimeRes"].as<double>()), fPosRes(10.)
   {
-    config.Output->Branch("CandFromCluster", &fCands);
+    Produce("CandFromCluster", fCands);
+    DeclareInput("Primaries");
   }
 
   bool CandFromCluster::DoReconstruct()
   {
     fCands.clear(); //Clear out the old clusters from last time!
 
-    const auto& vertex = fEvent->Primaries; //TODO: What to do when there are multiple vertices?  
+    const auto& vertex = fEvent.Primaries(); //TODO: What to do when there are multiple vertices?  
     
 	#ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
     const auto& vertPos = vertex.front().GetPosition();
@@ -65,7 +66,7 @@ namespace reco
       pers::NeutronCand seed;
       seed.DepositedEnergy = outer.Energy;
       seed.Start = outer.FirstPosition;
-      seed.ClusterAlgToIndices[fClusterAlgName].push_back(std::distance(fClusters.begin(), outerClustPos)); 
+      seed.AddCluster(fClusterAlgID, std::distance(fClusters.begin(), outerClustPos)); 
 
       const auto diff = seed.Start-vertPos;
       const auto dist = diff.Vect().Mag();
@@ -77,7 +78,7 @@ namespace reco
       seed.SigmaBeta = seed.Beta*std::sqrt(distUncert*distUncert+timeUncert*timeUncert); //Uncertainty in beta
       //const auto energy = mass/std::sqrt(1.-beta*beta); //E = gamma * mc^2
 
-      seed.TrackIDs.insert(outer.TrackIDs.begin(), outer.TrackIDs.end());
+      seed.AddTrackIDs(outer.TrackIDs.begin(), outer.TrackIDs.end());
       seed.TOFEnergy = mass/std::sqrt(1.-seed.Beta*seed.Beta); //E = gamma * mc^2
       fCands.push_back(seed);
     }
@@ -5,11 +5,9 @@
 //EdepNeutrons includes
 #include "reco/Reconstructor.h"
 #include "persistency/NeutronCand.h"
+#include "persistency/AlgNames.h"
 #include "persistency/MCCluster.h"
 
-//ROOT includes
-#include "TTreeReaderArray.h"
-
 #ifndef RECO_CANDFROMCLUSTER_H
 #define RECO_CANDFROMCLUSTER_H
 
@@ -28,9 +26,10 @@ namespace reco
       std::vector<pers::NeutronCand> fCands;
 
       //Location from which MCClusters will be read
-      TTreeReaderArray<pers::MCCluster> fClusters;
+      plgn::Handle<pers::MCCluster> fClusters;
 
       std::string fClusterAlgName; //Name of the cluster algorithm to be stitched
+      unsigned short fClusterAlgID; //ID of fClusterAlgName in pers::AlgNames
 
       //Configuration data
       double fTimeRes; //Time resolution for 3DST
@@ -7,19 +7,18 @@
 //EdepNeutrons includes
 #include "reco/Reconstructor.h"
 #include "persistency/NeutronCand.h"
+#include "persistency/AlgNames.h"
 #include "persistency/MCCluster.h"
-
-//ROOT includes
-#include "TTreeReaderArray.h"
+#include "reco/alg/LogPDFTable.h"
+#include "reco/alg/BestCandidates.h"
 
 //c++ includes
 #include <memory>
+#include <vector>
 
 #ifndef RECO_CANDFROMPDF_H
 #define RECO_CANDFROMPDF_H
 
-class TH2D;
-
 namespace reco
 {
   class CandFromPDF: public plgn::Reconstructor
@@ -28,6 +27,8 @@ namespace reco
       CandFromPDF(const plgn::Reconstructor::Config& config);
       virtual ~CandFromPDF() = default;
 
+      virtual Counters Stats() const override; //How often the greedy fallback was used
+
     protected:
       virtual bool DoReconstruct() override; //Look at what is already in the tree and do your own reconstruction.
 
@@ -35,15 +36,19 @@ namespace reco
       std::vector<pers::NeutronCand> fCands;
 
       //Location from which MCClusters will be read
-      TTreeReaderArray<pers::MCCluster> fClusters;
+      plgn::Handle<pers::MCCluster> fClusters;
 
       std::string fClusterAlgName; //Name of the cluster algorithm to be stitched
+      unsigned short fClusterAlgID; //ID of fClusterAlgName in pers::AlgNames
 
       //Configuration data
       double fTimeRes; //Time resolution for 3DST in ns
       double fPosRes; //Position resolution for 3DST in mm
-      std::unique_ptr<TH2D> fBetaVsEDep; //PDF of Beta between clusters versus energy deposited in a cluster
+      std::unique_ptr<LogPDFTable> fBetaVsEDep; //log10 of the PDF of Beta between clusters versus energy deposited in a cluster
       double fPenaltyTerm; //Likelihood function penalty per missing hit
+
+      BestCandidates fBestCands; //Groups MCClusters into the most likely candidates.  Counts how often its work budget runs out.
+      size_t fNEvents; //Number of events reconstructed
   };
 }
 
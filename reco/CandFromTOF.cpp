@@ -17,6 +17,7 @@
 
 //c++ includes
 #include <numeric> //std::accumulate got moved here in c++14
+#include <algorithm>
 
 namespace
 {
@@ -44,19 +45,21 @@ namespace
 namespace reco
 {
   CandFromTOF::CandFromTOF(const plgn::Reconstructor::Config& config): plgn::Reconstructor(config), fCands(), 
-                                                                       fClusters(*(config.Input), 
-                                                                                 config.Options["ClusterAlg"].as<std::string>().c_str()), 
+                                                                       fClusters(Consume<pers::MCCluster>(config.Options["ClusterAlg"].as<std::string>())), 
                                                                        fClusterAlgName(config.Options["ClusterAlg"].as<std::string>().c_str()), 
-                                                                       fTimeRes(config.Options["TimeRes"].as<double>()), fPosRes(10.)
+                                                                       fClusterAlgID(pers::AlgNames::ID(fClusterAlgName)),
+                                                                       fTimeRes(config.Options["TimeRes"].as<double>()), fPosRes(10.), 
+                                                                       fOrder(), fSorted(), fSeeds()
   {
-    config.Output->Branch("CandFromTOF", &fCands);
+    Produce("CandFromTOF", fCands);
+    DeclareInput("Primaries");
   }
 
   bool CandFromTOF::DoReconstruct()
   {
     fCands.clear(); //Clear out the old clusters from last time!
 
-    const auto& vertex = fEvent->Primaries; //TODO: What to do when there are multiple vertices?
+    const auto& vertex = fEvent.Primaries(); //TODO: What to do when there are multiple vertices?
 
 	#ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
     const auto& vertPos = vertex.front().GetPosition();
@@ -64,36 +67,37 @@ namespace reco
     const auto& vertPos = vertex.front().Position;
     #endif
 
-    //First, sort clusters by starting time to timing resolution, then distance to vertex  
-    //TODO: TTreeReaderArray::Iterator_t is NOT an STL random access iterator, so I can't use std::sort.  Maybe copy to my own STL container for 
-    //      sorting?
-    //std::sort(fClusters.begin(), fClusters.end(), std::bind(::less, vertPos)); 
-                                                  /*[&vertPos](const auto& first, const auto& second)
-                                                  {
-                                                    const auto deltaT = second.FirstPosition.T() - first.FirstPosition.T();
-                                                    if(std::fabs(deltaT) > 0.7) return deltaT < 0;
-                                                    return ((first.FirstPosition-vertPos).Vect().Mag() < (second.FirstPosition-vertPos).Vect().Mag());
-                                                  });*/
-
-    std::list<pers::NeutronCand> seeds; //Seeds for neutron candidates
-
     //Physical constants
     const double mass = 939.6;
     const float c = 299.792; //Speed of light = 300 mm/ns
 
-    //Next, loop over clusters in order and seed neutron candidates based on clusters that are close enough to each seed to have been caused 
+    //First, copy what I need to know about each cluster into flat arrays sorted by starting time.  Handles can't be 
+    //sorted in place, so sort indices instead.  stable_sort() keeps clusters that start at the same time in the order 
+    //they were made.  
+    fOrder.resize(fClusters.size());
+    std::iota(fOrder.begin(), fOrder.end(), 0);
+    std::stable_sort(fOrder.begin(), fOrder.end(), [this](const size_t first, const size_t second)
+                                                   { return fClusters[first].FirstPosition.T() < fClusters[second].FirstPosition.T(); });
+    fSorted.resize(fOrder.size());
+    for(size_t pos = 0; pos < fOrder.size(); ++pos)
+    {
+      const auto& clust = fClusters[fOrder[pos]];
+      fSorted[pos] = Cluster{clust.FirstPosition, clust.Position.T(), clust.Energy, fOrder[pos]};
+    }
+
+    //Next, loop over clusters in time order and seed neutron candidates based on clusters that are close enough to each seed to have been caused 
     //by the same FS neutron. 
-    for(auto outerClustPos = fClusters.begin(); outerClustPos != fClusters.end(); ++outerClustPos)
+    fSeeds.clear();
+    for(size_t outerPos = 0; outerPos < fSorted.size(); ++outerPos)
     {
-      auto& outer = *outerClustPos;
+      const auto& outer = fSorted[outerPos];
       if(outer.FirstPosition.T() - vertPos.T() > 3.*fTimeRes) //3ns
       //TODO: Tune this cut?
       {
-
-        pers::NeutronCand seed;
+        Seed seed;
         seed.DepositedEnergy = outer.Energy;
         seed.Start = outer.FirstPosition;
-        seed.ClusterAlgToIndices[fClusterAlgName].push_back(std::distance(fClusters.begin(), outerClustPos)); 
+        seed.Clusters.push_back(outerPos);
 
         const auto diff = seed.Start-vertPos;
         const auto dist = diff.Vect().Mag();
@@ -106,80 +110,77 @@ namespace reco
         //const auto energy = mass/std::sqrt(1.-beta*beta); //E = gamma * mc^2
 
         //Look for other seeds that are close enough to this seed that the same FS neutron could have visited both points.
-        seeds.remove_if([this, &seed, &vertPos, &c, &mass](const auto& other)
-                        {
-                          auto closest = std::min_element(other.ClusterAlgToIndices.find(fClusterAlgName)->second.begin(), 
-                                                          other.ClusterAlgToIndices.find(fClusterAlgName)->second.end(), 
-                                                          [this, &seed](const auto& first, const auto& second)
-                                                          {
-                                                            const auto& firstClust = fClusters[first];
-                                                            const auto& secondClust = fClusters[second];
-                                                            return ::less(firstClust.FirstPosition, secondClust.FirstPosition, seed.Start);
-                                                          });
-
-                          const auto relDiff = seed.Start - fClusters[*closest].FirstPosition;
-                          const auto relBeta = relDiff.Vect().Mag()/relDiff.T()/c;
+        //Each other seed already knows its earliest cluster and how much energy was deposited up to that cluster, so 
+        //each decision only looks at a few numbers.  Seeds that are merged are removed without changing the order of the rest.  
+        size_t kept = 0;
+        for(size_t otherPos = 0; otherPos < fSeeds.size(); ++otherPos)
+        {
+          auto& other = fSeeds[otherPos];
+          const auto& closest = fSorted[other.Closest];
+
+          const auto relDiff = seed.Start - closest.FirstPosition;
+          const auto relBeta = relDiff.Vect().Mag()/relDiff.T()/c;
         
-                          const auto& first = ::less(seed.Start, other.Start, vertPos)?seed:other;
-                          //std::cout << "Before correction for energy, beta was " << first.Beta << "\n";
-
-                          //TODO: Clusters need to be time-ordered for this to work 
-                          const double predictedE = mass/std::sqrt(1.-first.Beta*first.Beta)
-                                                    -std::accumulate(other.ClusterAlgToIndices.find(fClusterAlgName)->second.begin(),
-                                                                     other.ClusterAlgToIndices.find(fClusterAlgName)->second.end(), 
-                                                                     0., [this, &closest](double sum, const auto& index)
-                                                                         {
-                                                                           if(fClusters[index].Position.T() > fClusters[*closest].Position.T()) 
-                                                                             return sum;
-                                                                           return sum+fClusters[index].Energy;
-                                                                         });
-                          double predictedBeta;
-                          //TODO: Running into a problem where predictedBeta is -nan.  Physically, this could be caused by candidates where neutrons 
-                          //      "deposit" energy from the nuclei they interact with.  
-                          if(predictedE > mass) predictedBeta = std::sqrt(1.-mass*mass/predictedE/predictedE);
-                          else predictedBeta = first.Beta;
-                          //std::cout << "After correction for energy loss, beta is " << predictedBeta << "\n";
+          const bool seedFirst = ::less(seed.Start, other.Start, vertPos);
+          const double firstBeta = seedFirst?seed.Beta:other.Beta, firstSigmaBeta = seedFirst?seed.SigmaBeta:other.SigmaBeta;
+          //std::cout << "Before correction for energy, beta was " << firstBeta << "\n";
+
+          const double predictedE = mass/std::sqrt(1.-firstBeta*firstBeta) - other.EnergyBefore;
+          double predictedBeta;
+          //TODO: Running into a problem where predictedBeta is -nan.  Physically, this could be caused by candidates where neutrons 
+          //      "deposit" energy from the nuclei they interact with.  
+          if(predictedE > mass) predictedBeta = std::sqrt(1.-mass*mass/predictedE/predictedE);
+          else predictedBeta = firstBeta;
+          //std::cout << "After correction for energy loss, beta is " << predictedBeta << "\n";
                                                                      
-                          if(relBeta - predictedBeta <= first.SigmaBeta && predictedE > mass) //TODO: get uncertainty on predictedBeta instead
-                          //TODO: Rough parameterization of "invisible" energy loss of neutrons versus distance?
-                          {
-                            //Merge other into seed
-                            //I could write operator +() to do this, but there is no such example in edep-sim.  Keeping algorithms separated 
-                            //from persistency objects for now.  
-                            seed.DepositedEnergy += other.DepositedEnergy;
-                            seed.Start = first.Start;
-
-                            //merge maps
-                            auto& seedMap = seed.ClusterAlgToIndices;
-                            const auto& otherMap = other.ClusterAlgToIndices;
-                            for(const auto& otherPair: otherMap)
-                            {
-                              seedMap[otherPair.first].insert(seedMap[otherPair.first].end(), otherPair.second.begin(), otherPair.second.end());
-                            }
-
-                            seed.Beta = first.Beta;
-                            seed.SigmaBeta = first.SigmaBeta;
-
-                            return true;
-                          }
-                          return false;
-                        });
-
-        seeds.push_back(seed);
+          if(relBeta - predictedBeta <= firstSigmaBeta && predictedE > mass) //TODO: get uncertainty on predictedBeta instead
+          //TODO: Rough parameterization of "invisible" energy loss of neutrons versus distance?
+          {
+            //Merge other into seed
+            //I could write operator +() to do this, but there is no such example in edep-sim.  Keeping algorithms separated 
+            //from persistency objects for now.  
+            seed.DepositedEnergy += other.DepositedEnergy;
+            if(!seedFirst) seed.Start = other.Start;
+            seed.Clusters.insert(seed.Clusters.end(), other.Clusters.begin(), other.Clusters.end());
+            seed.Beta = firstBeta;
+            seed.SigmaBeta = firstSigmaBeta;
+          }
+          else 
+          {
+            if(kept != otherPos) fSeeds[kept] = std::move(other);
+            ++kept;
+          }
+        }
+        fSeeds.resize(kept);
+
+        //Update seed's summary for the next clusters.  Only happens once per cluster, so it's OK to loop over seed's clusters here.  
+        seed.Closest = *std::min_element(seed.Clusters.begin(), seed.Clusters.end()); //fSorted is in time order
+        seed.EnergyBefore = 0.;
+        for(const auto pos: seed.Clusters) 
+        {
+          if(fSorted[pos].PositionT <= fSorted[seed.Closest].PositionT) seed.EnergyBefore += fSorted[pos].Energy;
+        }
+
+        fSeeds.push_back(std::move(seed));
       }
     }
 
     //Calculate candidate aggregate properties
-    for(auto& cand: seeds)
+    for(const auto& seed: fSeeds)
     {
+      pers::NeutronCand cand;
+      cand.DepositedEnergy = seed.DepositedEnergy;
+      cand.Start = seed.Start;
+      cand.Beta = seed.Beta;
+      cand.SigmaBeta = seed.SigmaBeta;
+
       //Accumulate TrackIDs of Clusters in this candidate
-      for(const auto& src: cand.ClusterAlgToIndices)
+      for(const auto pos: seed.Clusters)
       {
-        for(const auto& index: src.second) 
-        {
-          const auto& clust = fClusters[index];
-          cand.TrackIDs.insert(clust.TrackIDs.begin(), clust.TrackIDs.end());
-        }
+        const auto index = fSorted[pos].Index;
+        cand.AddCluster(fClusterAlgID, index);
+        const auto& clust = fClusters[index];
+        cand.AddTrackIDs(clust.TrackIDs.begin(), clust.TrackIDs.end());
       }
 
       //Calculate neutron energy from TOF
@@ -6,10 +6,11 @@
 //EdepNeutrons includes
 #include "reco/Reconstructor.h"
 #include "persistency/NeutronCand.h"
+#include "persistency/AlgNames.h"
 #include "persistency/MCCluster.h"
 
-//ROOT includes
-#include "TTreeReaderArray.h"
+//c++ includes
+#include <vector>
 
 #ifndef RECO_CANDFROMTOF_H
 #define RECO_CANDFROMTOF_H
@@ -29,13 +30,41 @@ namespace reco
       std::vector<pers::NeutronCand> fCands;
 
       //Location from which MCClusters will be read
-      TTreeReaderArray<pers::MCCluster> fClusters;
+      plgn::Handle<pers::MCCluster> fClusters;
 
       std::string fClusterAlgName; //Name of the cluster algorithm to be stitched
+      unsigned short fClusterAlgID; //ID of fClusterAlgName in pers::AlgNames
 
       //Configuration data
       double fTimeRes; //Time resolution for 3DST
       double fPosRes; //Position resolution for 3DST
+
+    private:
+      //Everything about an MCCluster that deciding whether to merge seeds needs
+      struct Cluster
+      {
+        TLorentzVector FirstPosition; //MCCluster::FirstPosition
+        double PositionT; //Time of MCCluster::Position
+        double Energy; //MCCluster::Energy
+        size_t Index; //Index of this MCCluster in fClusters
+      };
+
+      //A NeutronCand that is still being built.  Refers to clusters by their positions in fSorted.
+      struct Seed
+      {
+        TLorentzVector Start;
+        double Beta;
+        double SigmaBeta;
+        double DepositedEnergy;
+        std::vector<size_t> Clusters; //Positions in fSorted of this seed's clusters in the order they were added
+        size_t Closest; //Position in fSorted of the earliest cluster in this seed
+        double EnergyBefore; //Energy of clusters in this seed whose Position is no later than Closest's
+      };
+
+      //Kept between events so that they don't have to allocate memory again
+      std::vector<size_t> fOrder; //Indices in fClusters sorted by FirstPosition.T()
+      std::vector<Cluster> fSorted; //Clusters sorted by FirstPosition.T()
+      std::vector<Seed> fSeeds; //Seeds for neutron candidates in the order they were made
   };
 }
 
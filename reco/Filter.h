@@ -0,0 +1,30 @@
+//File: Filter.h
+//Brief: A Filter is a Reconstructor that decides whether the rest of the plugins get to see an event at all.  Filters 
+//       run before every other Reconstructor, and they only get the parts of the TG4Event that they DeclareInput().
+//       If a Filter's DoReconstruct() returns false, no other Reconstructor or Analyzer sees that entry, and nothing 
+//       is written for it except to keep a friend TTree lined up.  If all Filters return true, the entry is written 
+//       out even if no other Reconstructor found anything, so a job with only Filters is a skim.  
+//
+//       Filters can't Consume() anything another Reconstructor in the same job Produce()s.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//EdepNeutrons includes
+#include "reco/Reconstructor.h"
+
+#ifndef PLGN_FILTER_H
+#define PLGN_FILTER_H
+
+namespace plgn
+{
+  class Filter: public Reconstructor
+  {
+    public:
+      Filter(const Config& config): Reconstructor(config) {}
+      virtual ~Filter() = default;
+
+    protected:
+      virtual bool DoReconstruct() override = 0; //Return true to keep this event
+  };
+}
+
+#endif //PLGN_FILTER_H
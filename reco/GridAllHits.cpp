@@ -15,15 +15,19 @@
 #include "TGeoNode.h"
 #include "TGeoVolume.h"
 #include "TGeoBBox.h"
+#include "TTree.h"
 
 //EdepNeutrons includes
 #include "reco/GridAllHits.h"
 #include "persistency/MCHit.h"
 #include "app/Factory.cpp"
 #include "reco/alg/GeoFunc.h"
+#include "reco/alg/GeoService.h"
+#include "reco/alg/SegmentTable.h"
 
 //c++ includes
 #include <set>
+#include <algorithm>
 
 
 /*namespace plgn
@@ -46,9 +50,10 @@ namespace reco
                                                                        fEMin(config.Options["EMin"].as<double>()), 
                                                                        fHitAlg(config.Options["CubeSize"].as<double>(), 
                                                                                config.Options["AfterBirks"].as<bool>(),  
-                                                                               config.Options["TimeRes"].as<double>())
+                                                                               config.Options["TimeRes"].as<double>()),
+                                                                       fSegments(UseSegments())
   {
-    config.Output->Branch("GridAllHits", &fHits);
+    Produce("GridAllHits", fHits);
   }
 
   //Produce MCHits from TG4HitSegments descended from FS neutrons above threshold
@@ -58,46 +63,38 @@ namespace reco
     fHits.clear();
 
     //Get geometry information about this detector
-    auto shape = fGeo->FindVolumeFast("volA3DST_PV")->GetShape();
-    auto mat = geo::findMat("volA3DST_PV", *(fGeo->GetTopNode()));
+    const auto mat = &fGeometry.Fiducial().Matrix;
     
     //Form MCHits from all remaining hit segments
     //First, create a sparse vector of MCHits to accumulate energy in each cube.  But that's a map, you say!  
-    //std::map is a more memory-efficient way to implement a sparse vector than just a std::vector with lots of blank 
+    //A sparse map is a more memory-efficient way to implement a sparse vector than just a std::vector with lots of blank 
     //entries.  Think of the RAM needed for ~1e7 MCHits in each event!  
-    std::map<GridHits::Triple, GridHits::HitData> hits; //TODO: Write this interface so I never have to know about this map
+    auto& hits = fHitData;
+    hits.clear();
                                                                                                                          
     //Next, add each segment to the hit(s) it enters.  This way, I loop over each segment exactly once.
     //Not actually storing all of the data for an MCHit because Width is the same for all MCHits made by this algorithm 
     //and Position can be reconstituted from a Triple key. 
 
     //Next, find all TG4HitSegments that are descended from an interesting FS particle.   
-    for(const auto& det: fEvent->SegmentDetectors) //Loop over sensitive detectors
-    { 
-      for(const auto& seg: det.second)
+    //fSegments already has every segment in the detector's coordinate system with the fiducial cut applied.
+    for(size_t row = 0; row < fSegments.size(); ++row)
+    {
+      if(fSegments.Fiducial[row]) //TODO: Put this back
       {
-        //Fiducial cut
-		#ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-        const auto segStart = seg.GetStart();
-        #else
-        const auto segStart = seg.Start;
-        #endif
-
-        const auto start = geo::InLocal(segStart.Vect(), mat);
-        double arr[] = {start.X(), start.Y(), start.Z()};
-        if(shape->Contains(arr)) //TODO: Put this back
-        {
-          fHitAlg.MakeHitData(seg, hits, mat, [](const auto& /*elm*/){ return false; });
-        } //If passes fiducial cut
-      } //For each segment in this detector
-    } //For each detector 
+        fHitAlg.MakeHitData(*(fSegments.Segment[row]), fSegments.Local(row), hits, [](const auto& /*elm*/){ return false; });
+      } //If passes fiducial cut
+    } //For each segment in this event
 
-    //Save the hits created
+    //Save the hits created.  Write them in order of position like when hits was a std::map.  There are a lot fewer of 
+    //these than voxels that were looked up.  
+    std::vector<const std::pair<GridHits::Triple, GridHits::HitData>*> visible;
     for(const auto& pair: hits)
     {
-      const auto out = fHitAlg.MakeHit(pair, mat);
-      if(out.Energy > fEMin) fHits.push_back(out); //TODO: If I were going to make a cut on energy from non-neutrons, this is the place to do it
+      if(pair.second.Energy > fEMin) visible.push_back(&pair); //TODO: If I were going to make a cut on energy from non-neutrons, this is the place to do it
     }
+    std::sort(visible.begin(), visible.end(), [](const auto lhs, const auto rhs) { return lhs->first < rhs->first; });
+    for(const auto pair: visible) fHits.push_back(fHitAlg.MakeHit(*pair, mat));
 
     return !(fHits.empty());
   }
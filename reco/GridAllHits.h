@@ -7,6 +7,7 @@
 //EdepNeutrons includes
 #include "reco/Reconstructor.h"
 #include "reco/alg/GridHits.h"
+#include "reco/alg/SegmentTable.h"
 #include "persistency/MCHit.h"
 
 #ifndef RECO_GRIDALLHITS_H
@@ -31,6 +32,8 @@ namespace reco
                     //with less than this amount of KE are not interesting to me.   
 
       GridHits fHitAlg; //Algorithm for grouping TG4HitSegments into MCHits       
+      GridHits::HitMap fHitData; //Energy in each cube.  Kept between events so that it doesn't allocate memory every time.
+      const SegmentTable& fSegments; //TG4HitSegments in the detector's coordinate system.  Shared with other plugins.
 
       //Internal functions
   };
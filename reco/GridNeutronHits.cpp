@@ -15,44 +15,30 @@
 #include "TGeoNode.h"
 #include "TGeoVolume.h"
 #include "TGeoBBox.h"
+#include "TTree.h"
 
 //EdepNeutrons includes
 #include "reco/GridNeutronHits.h"
 #include "persistency/MCHit.h"
 #include "app/Factory.cpp"
 #include "reco/alg/GeoFunc.h"
-#include "alg/TruthFunc.h"
+#include "reco/alg/GeoService.h"
+#include "reco/alg/SegmentTable.h"
 
 //c++ includes
 #include <set>
-
-namespace
-{
-  void RecursiveRemove(const reco::GridHits::Triple& pos, std::map<reco::GridHits::Triple, std::list<reco::GridHits::Triple>>& passed, 
-                       std::map<reco::GridHits::Triple, std::list<reco::GridHits::Triple>>& failed)
-  {
-    //TODO: Failure in comparison operator -> I'm corrupting the map's memory somewhere?  Recursion really is a bad strategy here to begin with.  Look for something else.  
-    auto found = failed.find(pos);
-    if(found == failed.end()) found = passed.find(pos);
-    else failed.erase(pos);
-    if(found == passed.end()) return; //Nothing to do?
-    else passed.erase(pos); 
-                                                                                                                     
-    for(const auto& neighbor: found->second) 
-    {
-      RecursiveRemove(neighbor, passed, failed); 
-    }
-  }
-}
+#include <algorithm>
 
 namespace reco
 {
   GridNeutronHits::GridNeutronHits(const plgn::Reconstructor::Config& config): plgn::Reconstructor(config), fHits(), 
                                                                                fHitAlg(config.Options["CubeSize"].as<double>(), 
                                                                                        config.Options["AfterBirks"].as<bool>(), 
-                                                                                       config.Options["TimeRes"].as<double>())
+                                                                                       config.Options["TimeRes"].as<double>()),
+                                                                               fSegments(UseSegments()), fTruth(UseTruth())
   {
-    config.Output->Branch("GridNeutronHits", &fHits);
+    Produce("GridNeutronHits", fHits);
+    DeclareInput("Primaries");
     
     fEMin = config.Options["EMin"].as<double>();
     fNeighborDist = config.Options["NeighborCut"].as<size_t>();
@@ -65,39 +51,26 @@ namespace reco
     fHits.clear();
 
     //Get geometry information about this detector
-    const std::string fiducial = "volA3DST_PV";
-    auto mat = geo::findMat(fiducial, *(fGeo->GetTopNode()));
-    auto shape = fGeo->FindVolumeFast(fiducial.c_str())->GetShape();
+    const auto mat = &fGeometry.Fiducial().Matrix; //Only looked up once per file
                                                                                                                          
     //Form MCHits from all remaining hit segments
     //First, create a sparse vector of MCHits to accumulate energy in each cube.  But that's a map, you say!  
-    //std::map is a more memory-efficient way to implement a sparse vector than just a std::vector with lots of blank 
+    //A sparse map is a more memory-efficient way to implement a sparse vector than just a std::vector with lots of blank 
     //entries.  Think of the RAM needed for ~1e7 MCHits in each event!  
-    std::map<GridHits::Triple, GridHits::HitData> hits;
+    auto& hits = fHitData;
+    hits.clear();
                                                                                                                          
     //Set up to determine whether each TG4HitSegment came from a neutron 
     const auto neutDescendIDs = NeutDescend();
     if(neutDescendIDs.empty()) return false; //If there are no neutron-descneded hits in this event, there is nothing to do.
 
     //Next, find all TG4HitSegments that are descended from an interesting FS particle.   
-    for(const auto& det: fEvent->SegmentDetectors) //Loop over sensitive detectors
+    //fSegments already has every segment in the detector's coordinate system with the fiducial cut applied.
+    for(size_t row = 0; row < fSegments.size(); ++row)
     { 
-      for(const auto& seg: det.second)
+      if(fSegments.Fiducial[row]) 
       {
-		#ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-        const auto segStart = seg.GetStart();
-		const auto segStop = seg.GetStop();
-        #else
-        const auto segStart = seg.Start;
-		const auto segStop = seg.Stop;
-        #endif
-        //Fiducial cut
-        const auto start = geo::InLocal(segStart.Vect(), mat);
-        const auto stop = geo::InLocal(segStop.Vect(), mat);
-        double arr[] = {start.X(), start.Y(), start.Z()};
-        if(shape->Contains(arr)) 
-        {
-          fHitAlg.MakeHitData(seg, hits, mat, [&neutDescendIDs](const auto& seg)
+        fHitAlg.MakeHitData(*(fSegments.Segment[row]), fSegments.Local(row), hits, [&neutDescendIDs](const auto& seg)
 			{
 				#ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
 				const int segPrimary = seg.GetPrimaryId();
@@ -106,72 +79,34 @@ namespace reco
 				#endif 
 				return !(neutDescendIDs.count(segPrimary)); 
 			});
-        } //If this hit segment is in the fiducial volume
-      } //Loop over all hit segments in this sensitive detector 
-    } //For each sensitive detector
+      } //If this hit segment is in the fiducial volume
+    } //For each segment in this event
 
-    //Group hits by whether they passed the neighbor cut.  Then, I can perform another neighbor cut among neutron-caused hits to 
-    //weed out hits that are part of neutron-induced tracks that start too close to non-neutron or non-visible hits.  
-    std::map<GridHits::Triple, std::list<GridHits::Triple>> passedHits, failedHits;
+    //A cube above fEMin is a candidate neutron hit if neutron descendants dominate it.  Candidates fail if they are too close 
+    //to a visible non-neutron hit or if a chain of neighboring candidates connects them to one that is.  
+    fNeighborCut.clear();
     for(const auto& pair: hits)
     {
-      //const auto out = fHitAlg.MakeHit(pair, mat);
       const auto& hit = pair.second;
-      if(hit.Energy > fEMin && hit.Energy > 4.*hit.OtherE) 
-      {
-        std::list<GridHits::Triple> neutronNeighbors;
-        if(Neighbors(pair, hits, fNeighborDist, neutronNeighbors)) 
-        {
-          //fHits.push_back(out); //Look for adjacent neighbors
-          //hits.remove(pair.first); //TODO: Remove this hit from the list of hits to consider when making Neighbors cuts.  
-                                     //      What happens with hits I haven't processed yet?  I really need to know the Neighbors() 
-                                     //      results for all potential "good neutron hits" before I can make the Neighbors() cut this 
-                                     //      way.  
-          passedHits[pair.first].insert(passedHits[pair.first].end(), neutronNeighbors.begin(), neutronNeighbors.end());
-        }
-        else
-        {
-          failedHits[pair.first].insert(failedHits[pair.first].end(), neutronNeighbors.begin(), neutronNeighbors.end());
-        }
-      }
-    }
-
-    //Remove all hits that are neighbors of a bad hit, including hits that become bad hits in this process
-    //While number of passed hits is changing
-    size_t prevSize = passedHits.size()+1;
-    while(passedHits.size() < prevSize)
-    {
-      prevSize = passedHits.size();
-      for(const auto& hit: failedHits)
+      if(hit.Energy > fEMin)
       {
-        for(const auto& pos: hit.second) 
-        {
-          auto found = passedHits.find(pos);
-          if(found != passedHits.end())
-          {
-            failedHits[pos] = found->second;
-            passedHits.erase(found);
-          }
-          //::RecursiveRemove(pos, passedHits, failedHits);
-        }
-        failedHits.erase(hit.first);
+        if(hit.Energy > 4.*hit.OtherE) fNeighborCut.AddCandidate(pair.first);
+        else fNeighborCut.AddOther(pair.first);
       }
     }
 
     //Save the remaining hits that were caused primarily by ancestors of FS neutrons and were isolated from hits that will not be saved.  
-    for(const auto& good: passedHits)
-    {
-      fHits.push_back(fHitAlg.MakeHit(*(hits.find(good.first)), mat));
-    }
+    //Passed() is sorted, so MCHits are written in order of position.
+    for(const auto& good: fNeighborCut.Passed(fNeighborDist)) fHits.push_back(fHitAlg.MakeHit(*(hits.find(good)), mat));
 
     return !(fHits.empty());
   }
 
-  std::set<int> GridNeutronHits::NeutDescend()
+  std::set<int> GridNeutronHits::NeutDescend() const
   {
     std::set<int> neutDescendIDs; //TrackIDs of FS neutron descendants
-    const auto& trajs = fEvent->Trajectories;
-    const auto& vertices = fEvent->Primaries;
+    const auto& trajs = fEvent.Trajectories();
+    const auto& vertices = fEvent.Primaries();
     for(const auto& vtx: vertices)
     {
       for(const auto& prim: vtx.Particles)
@@ -188,7 +123,7 @@ namespace reco
 
         if(strcmp(name, "neutron") == 0 && mom.E()-mom.Mag() > fEMin)
         {
-          truth::Descendants(primId, trajs, neutDescendIDs);
+          fTruth.Descendants(primId, neutDescendIDs);
           neutDescendIDs.insert(primId);
         }
         //else std::cout << "Primary named " << prim.Name << " with KE " << mom.E()-mom.Mag() << " is not a FS neutron.\n";
@@ -197,36 +132,5 @@ namespace reco
     return neutDescendIDs;
   }
 
-  //TODO: I *could* unwrap these loops at compile-time, but I don't see a good reason to put in that much effort just yet.  
-  //TODO: Make Neighbors cut on hits themselves.  Maybe record somewhere where Neighbors() cut failed so that I don't get an awful recursive mess?
-  //Loop over HitData in map of all hits and return whether there is a non-neutron hit within nCubes of cand.   
-  bool GridNeutronHits::Neighbors(const std::pair<GridHits::Triple, GridHits::HitData>& cand, 
-                                  const std::map<GridHits::Triple, GridHits::HitData>& hits, const size_t nCubes, 
-                                  std::list<GridHits::Triple>& neutronNeighbors) const
-  {
-    bool noNeighbors = true;
-    auto key = cand.first;
-    for(int xOff = -(int)nCubes; xOff < (int)nCubes+1; ++xOff)
-    {
-      for(int yOff = -(int)nCubes; yOff < (int)nCubes+1; ++yOff)
-      {
-        for(int zOff = -(int)nCubes; zOff < (int)nCubes+1; ++zOff)
-        {
-          auto offPos = key;
-          offPos.First += xOff;
-          offPos.Second += yOff;
-          offPos.Third += zOff;
-          auto found = hits.find(offPos);
-          if(found != hits.end() && found->second.Energy > fEMin)
-          {
-            if(found->second.Energy > 4.*found->second.OtherE) neutronNeighbors.push_back(offPos);
-            else noNeighbors = false;
-          }
-        }
-      }
-    }
-    return noNeighbors;
-  }
-
   REGISTER_PLUGIN(GridNeutronHits, plgn::Reconstructor)
 }
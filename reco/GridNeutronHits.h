@@ -8,6 +8,9 @@
 #include "reco/Reconstructor.h"
 #include "persistency/MCHit.h"
 #include "reco/alg/GridHits.h"
+#include "reco/alg/NeighborCut.h"
+#include "reco/alg/SegmentTable.h"
+#include "alg/TrajectoryIndex.h"
 
 #ifndef RECO_GRIDNEUTRONHITS_H
 #define RECO_GRIDNEUTRONHITS_H
@@ -32,12 +35,14 @@ namespace reco
       size_t fNeighborDist; //How far away should I look for interfering neighbors when deciding to keep hits.  
 
       GridHits fHitAlg; //Algorithm for grouping TG4HitSegments into MCHits 
+      GridHits::HitMap fHitData; //Energy in each cube.  Kept between events so that it doesn't allocate memory every time.
+      NeighborCut<GridHits::Triple> fNeighborCut; //Decides which cubes neutron descendants dominate are isolated.  Kept between 
+                                                  //events so that it doesn't allocate memory every time.
+      const SegmentTable& fSegments; //TG4HitSegments in the detector's coordinate system.  Shared with other plugins.
+      const truth::TrajectoryIndex& fTruth; //Which TG4Trajectories came from which.  Shared with other plugins.
 
       //Internal functions
-      std::set<int> NeutDescend(); //Should be const, but I think TTreeReaderArray is not const-correct.
-      //TODO: The loop in neighbors *could* be unwrapped at compile-time, but I'm not sure it's worth the extreme amount of effort needed.
-      bool Neighbors(const std::pair<GridHits::Triple, GridHits::HitData>& cand, const std::map<GridHits::Triple, GridHits::HitData>& hits, 
-                     const size_t nCubes, std::list<GridHits::Triple>& neutronNeighbors) const;
+      std::set<int> NeutDescend() const; //TrackIDs of FS neutrons above fEMin and all of their descendants
   };
 }
 
@@ -7,9 +7,7 @@
 #include "reco/Reconstructor.h"
 #include "persistency/MCHit.h"
 #include "persistency/MCCluster.h"
-
-//ROOT includes
-#include "TTreeReaderArray.h"
+#include "reco/alg/HitClusterer.h"
 
 #ifndef RECO_MERGEDCLUSTERS_H
 #define RECO_MERGEDCLUSTERS_H
@@ -29,12 +27,14 @@ namespace reco
       std::vector<pers::MCCluster> fClusters;
 
       //Location from which MCHits will be read
-      TTreeReaderArray<pers::MCHit> fHits;
+      plgn::Handle<pers::MCHit> fHits;
 
       size_t fMergeDist; //Number of empty cubes over which clusters can "jump".  A value of 0 means cubes must be adjacent to form 
                          //clusters.  
                          
       std::string fHitAlgName; //Name of the hit algorithm to be clustered
+
+      HitClusterer fClusterAlg; //Groups neighboring MCHits without comparing every pair of MCHits
   };
 }
 
@@ -15,13 +15,15 @@
 #include "TGeoNode.h"
 #include "TGeoVolume.h"
 #include "TGeoBBox.h"
+#include "TTree.h"
 
 //EdepNeutrons includes
 #include "reco/NeutronHits.h"
 #include "persistency/MCHit.h"
 #include "app/Factory.cpp"
-#include "alg/TruthFunc.h"
 #include "reco/alg/GeoFunc.h"
+#include "reco/alg/GeoService.h"
+#include "reco/alg/SegmentTable.h"
 
 //c++ includes
 #include <set>
@@ -37,9 +39,10 @@ namespace
 
 namespace reco
 {
-  NeutronHits::NeutronHits(const plgn::Reconstructor::Config& config): plgn::Reconstructor(config), fHits(), fWidth(100.), fEMin(2.)
+  NeutronHits::NeutronHits(const plgn::Reconstructor::Config& config): plgn::Reconstructor(config), fHits(), fWidth(100.), fEMin(2.), 
+                                                                       fSegments(UseSegments()), fTruth(UseTruth())
   {
-    config.Output->Branch("NeutronHits", &fHits);
+    Produce("NeutronHits", fHits);
   }
 
   //Produce MCHits from TG4HitSegments descended from FS neutrons above threshold
@@ -52,7 +55,7 @@ namespace reco
     //First, figure out which TG4Trajectories are descendants of particles I am interested in.  
     //I am interested in primary neutrons with > 2 MeV KE.   
     std::set<int> neutDescendIDs; //TrackIDs of FS neutron descendants
-    const auto trajs = fEvent->Trajectories;
+    const auto trajs = fEvent.Trajectories();
     for(const auto& traj: trajs)
     {
       #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
@@ -70,7 +73,7 @@ namespace reco
         const int id = traj.TrackId;
         #endif
         neutDescendIDs.insert(id);
-        truth::Descendants(id, trajs, neutDescendIDs);
+        fTruth.Descendants(id, neutDescendIDs);
       }
     }
 
@@ -79,31 +82,20 @@ namespace reco
 
     //Next, find all TG4HitSegments that are descended from an interesting FS particle.   
     //TODO: Fiducial cut
-    for(const auto& det: fEvent->SegmentDetectors) //Loop over sensitive detectors
+    for(size_t det = 0; det < fSegments.NDetectors(); ++det) //Loop over sensitive detectors
     { 
       //Get geometry information about this detector
-      const std::string fiducial = "volA3DST_PV";
-      auto mat = geo::findMat(fiducial, *(fGeo->GetTopNode()));
-      auto shape = fGeo->FindVolumeFast(fiducial.c_str())->GetShape();
+      const auto mat = &fGeometry.Fiducial().Matrix; //Only looked up once per file
 
       TVector3 center(); 
       std::list<TG4HitSegment> neutSegs, others;
-      for(const auto& seg: det.second) //Loop over TG4HitSegments in this sensitive detector
+      for(size_t row = fSegments.DetectorBegin(det); row < fSegments.DetectorEnd(det); ++row) //Loop over TG4HitSegments in this sensitive detector
       {
-        #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-        const auto segStart = seg.GetStart();
-        const int segPrim = seg.GetPrimaryId();
-        #else
-        const auto segStart = seg.Start;
-        const int segPrim = seg.PrimaryId;
-        #endif
-
-        const auto local = geo::InLocal(segStart.Vect(), mat);
-        double arr[] = {local.X(), local.Y(), local.Z()};
-        if(shape->Contains(arr)) //Intentionally not extrapolating to the boundary.  Very reasonable to leave 
-                                 //some room before the boundary in a real detector anyway.  
+        const auto& seg = *(fSegments.Segment[row]);
+        if(fSegments.Fiducial[row]) //Intentionally not extrapolating to the boundary.  Very reasonable to leave 
+                                    //some room before the boundary in a real detector anyway.  
         {
-          if(neutDescendIDs.count(segPrim)) neutSegs.push_back(seg);
+          if(neutDescendIDs.count(fSegments.PrimaryId[row])) neutSegs.push_back(seg);
           else others.push_back(seg);
         }
       }
@@ -5,6 +5,8 @@
 
 //EdepNeutrons includes
 #include "reco/Reconstructor.h"
+#include "reco/alg/SegmentTable.h"
+#include "alg/TrajectoryIndex.h"
 #include "persistency/MCHit.h"
 
 #ifndef RECO_NEUTRONHITS_H
@@ -28,6 +30,9 @@ namespace reco
       double fWidth; //The width in mm of each dimension of a MCHit. 
       double fEMin; //The energy threshold in MeV for creating an MCHit.  Neutrons 
                     //with less than this amount of KE are not interesting to me.   
+
+      const SegmentTable& fSegments; //TG4HitSegments in the detector's coordinate system.  Shared with other plugins.
+      const truth::TrajectoryIndex& fTruth; //Which TG4Trajectories came from which.  Shared with other plugins.
   };
 }
 
@@ -15,257 +15,31 @@
 #include "TGeoNode.h"
 #include "TGeoVolume.h"
 #include "TGeoBBox.h"
+#include "TTree.h"
 
 //EdepNeutrons includes
 #include "reco/NoGridNeutronHits.h"
 #include "persistency/MCHit.h"
 #include "app/Factory.cpp"
 #include "reco/alg/GeoFunc.h"
-#include "alg/TruthFunc.h"
+#include "reco/alg/GeoService.h"
+#include "reco/alg/SegmentTable.h"
+#include "reco/alg/SegmentBVH.h"
 
 //c++ includes
 #include <set>
 #include <numeric> //TODO: Not needed if not using gcc 6.  std::accumulate should be in <algorithm> instead.
 
-namespace
-{
-  //(Improved?) geometry algorithm:
-  //Split space into octants around the interaction vertex.  
-  //Determine which octant a hit segment is in by "asking" 6 questions of the form:
-  //Is your start (X, Y, Z) < center (X, Y, Z)?
-  //Is your end (X, Y, Z) < center (X, Y, Z)?
-  //Are those the same?  
-  //If yes, assign hemisphere.  Do other hemispheres.  
-  //If no, assign to general boundary group.  
-  //Assuming boundary group is small, when looking for hit segments in same MCHit, look 
-  //only at own octant plus boundary group.  Could make boundary group for each hemisphere if 
-  //needed.  
-  //
-  //If still too many entries, could subdivide again.  Could probably subdivide each octant individually until 
-  //few enough hit segments in group.   
-
-  //TODO: Probably terrible object design
-
-  //Classes for custom geometry sorting algorithm.  
-  class ZHemisphere
-  {
-    public:
-      ZHemisphere(const TVector3& center): Center(center) {}
-      virtual ~ZHemisphere() = default;
-                                                                                                                                                            
-      TVector3 Center;
-                                                                                                                                                            
-      virtual std::list<TG4HitSegment>& operator [](const TG4HitSegment& hit) = 0;
-      virtual size_t size() const = 0;
-      virtual TG4HitSegment& first() = 0;
-  };
-   
-  class YHemisphere
-  {
-    public:
-      YHemisphere(const TVector3& center, const double width, const int subdiv);
-   
-      virtual ~YHemisphere() = default;  
-                                                                                                                                                            
-      TVector3 Center;
-      std::unique_ptr<ZHemisphere> Plus;
-      std::unique_ptr<ZHemisphere> Minus;
-  
-      virtual std::list<TG4HitSegment>& operator [](const TG4HitSegment& hit)
-      {
-		#ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-        auto hitStart = hit.GetStart();
-		auto hitStop = hit.GetStop();
-        #else
-        auto& hitStart = hit.Start;
-		auto& hitStop = hit.Stop;
-        #endif
-
-        bool start = (hitStart.Y() < Center.Y());
-        bool stop = (hitStop.Y() < Center.Y());
-  
-        if(start == stop) return start?(*Minus)[hit]:(*Plus)[hit]; //A straight line that starts and ends in the same octant cannot visit any other octants
-
-        double startDiff = std::fabs(hitStart.Y() - Center.Y()), stopDiff = std::fabs(hitStop.Y() - Center.Y());
-        if(startDiff > stopDiff)
-        {
-          return start?(*Minus)[hit]:(*Plus)[hit];
-        }
-        return stop?(*Minus)[hit]:(*Plus)[hit];
-      }
-
-      size_t size() const
-      {
-        return Plus->size()+Minus->size();
-      }
-
-      TG4HitSegment& first()
-      {
-        if(Plus->size() > 0) return Plus->first();
-        return Minus->first();
-      }
-  };
-
-  class XHemisphere
-  {
-    public:
-      XHemisphere(const TVector3& center, const double width, const int subdiv): Center(center), Plus(center+TVector3(width/2., 0., 0.), width, subdiv), 
-                                                                                 Minus(center-TVector3(width/2., 0., 0.), width, subdiv) {};
-      virtual ~XHemisphere() = default;
-  
-      TVector3 Center;
-      YHemisphere Plus;
-      YHemisphere Minus;
-  
-      std::list<TG4HitSegment>& operator [](const TG4HitSegment& hit)
-      {
-		#ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-        auto hitStart = hit.GetStart();
-		auto hitStop = hit.GetStop();
-        #else
-        auto& hitStart = hit.Start;
-		auto& hitStop = hit.Stop;
-        #endif
-
-        bool start = (hitStart.X() < Center.X());
-        bool stop = (hitStop.X() < Center.X());
-  
-        if(start == stop) return start?Minus[hit]:Plus[hit]; //A straight line that starts and ends in the same octant cannot visit any other octants
-
-        double startDiff = std::fabs(hitStart.Y() - Center.Y()), stopDiff = std::fabs(hitStop.Y() - Center.Y());
-        if(startDiff > stopDiff)
-        {
-          return start?Minus[hit]:Plus[hit];
-        }
-        return stop?Minus[hit]:Plus[hit];
-      }
-
-      size_t size() const
-      {
-        return Plus.size()+Minus.size();
-      }
-
-      TG4HitSegment& first()
-      {
-        if(Plus.size() > 0) return Plus.first();
-        return Minus.first();
-      }
-  };
-
-  //The final Z hemisphere.  Breaks the recursive operator [] calls.
-  class ZEnd: public ZHemisphere
-  {
-    public:
-      ZEnd(const TVector3& center): ZHemisphere(center), Plus(), Minus() {}      
-      virtual ~ZEnd() = default;
-
-      std::list<TG4HitSegment> Plus;
-      std::list<TG4HitSegment> Minus;
-
-      virtual std::list<TG4HitSegment>& operator [](const TG4HitSegment& hit)
-      {
-		#ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-        auto hitStart = hit.GetStart();
-		auto hitStop = hit.GetStop();
-        #else
-        auto& hitStart = hit.Start;
-		auto& hitStop = hit.Stop;
-        #endif
-
-        bool start = (hitStart.Z() < Center.Z());
-        bool stop = (hitStop.Z() < Center.Z());
-
-        if(start == stop) return start?Minus:Plus; //A straight line that starts and ends in the same octant cannot visit any other octants
-
-        double startDiff = std::fabs(hitStart.Y() - Center.Y()), stopDiff = std::fabs(hitStop.Y() - Center.Y());
-        if(startDiff > stopDiff)
-        {
-          return start?Minus:Plus;
-        }
-        return stop?Minus:Plus;
-      }
-
-      virtual size_t size() const
-      {
-        return Plus.size()+Minus.size();
-      }
-
-      virtual TG4HitSegment& first()
-      {
-        if(Plus.size() > 0) return *(Plus.begin());
-        return *(Minus.begin());
-      }
-  };
-
-  //Subdivide again!  Hardcoding two subdivisions max in the constructor for now.
-  class  ZMore: public ZHemisphere
-  {
-    public:
-      ZMore(const TVector3& center, const double width, const int subdiv): ZHemisphere(center), Plus(center+TVector3(0., 0., width/2.), width/2., subdiv-1), 
-                                                                           Minus(center-TVector3(0., 0., width/2.), width/2., subdiv-1) {} 
-      ZMore() = delete;
-      virtual ~ZMore() = default;
-  
-      XHemisphere Plus;
-      XHemisphere Minus;
-  
-      virtual std::list<TG4HitSegment>& operator [](const TG4HitSegment& hit)
-      {
-		#ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-        auto hitStart = hit.GetStart();
-		auto hitStop = hit.GetStop();
-        #else
-        auto& hitStart = hit.Start;
-		auto& hitStop = hit.Stop;
-        #endif
-
-        bool start = (hitStart.Z() < Center.Z());
-        bool stop = (hitStop.Z() < Center.Z());
-  
-        if(start == stop) return start?Minus[hit]:Plus[hit]; //A straight line that starts and ends in the same octant cannot visit any other octants
-
-        double startDiff = std::fabs(hitStart.Y() - Center.Y()), stopDiff = std::fabs(hitStop.Y() - Center.Y());
-        if(startDiff > stopDiff)
-        {
-          return start?Minus[hit]:Plus[hit];
-        }
-        return stop?Minus[hit]:Plus[hit];
-      }
-
-      virtual size_t size() const
-      {
-        return Plus.size()+Minus.size();
-      }
-
-      virtual TG4HitSegment& first()
-      {
-        if(Plus.size() > 0) return Plus.first();
-        return Minus.first();
-      }
-  };
-
-  YHemisphere::YHemisphere(const TVector3& center, const double width, const int subdiv): Center(center), Plus(), Minus()
-  {
-    if(subdiv > 0)
-    {
-      Plus.reset(new ZMore(center+TVector3(0., width/2., 0.), width, subdiv));
-      Minus.reset(new ZMore(center+TVector3(0., width/2., 0.), width, subdiv));
-    }
-    else
-    {
-      Plus.reset(new ZEnd(center+TVector3(0., width/2., 0.)));
-      Minus.reset(new ZEnd(center+TVector3(0., width/2., 0.)));
-    }
-  }
-}
-
 namespace reco
 {
-  NoGridNeutronHits::NoGridNeutronHits(const plgn::Reconstructor::Config& config): plgn::Reconstructor(config), fHits()
+  NoGridNeutronHits::NoGridNeutronHits(const plgn::Reconstructor::Config& config): plgn::Reconstructor(config), fHits(), 
+                                                                                   fSegments(UseSegments()), fTruth(UseTruth()),
+                                                                                   fNeutronRows(), fOtherRows(), fNeutronBVH(), fOtherBVH(), fAbsorbed()
   {
     //TODO: Rewrite interface to allow configuration?  Maybe pass in opt::CmdLine in constructor, then 
     //      reconfigure from opt::Options after Parse() was called? 
-    config.Output->Branch("NoGridNeutronHits", &fHits);
+    Produce("NoGridNeutronHits", fHits);
+    DeclareInput("Primaries");
 
     fEMin = config.Options["EMin"].as<double>();
     fWidth = config.Options["CubeSize"].as<size_t>();
@@ -283,8 +57,8 @@ namespace reco
     //TODO: truth::Matriarch() and Descendants() sometimes give different results!  I am not entirely convinced by the 
     //      results of Descendants(), so trying truth::Matriarch() as main method.  
     std::set<int> neutDescendIDs; //TrackIDs of FS neutron descendants
-    const auto trajs = fEvent->Trajectories;
-    const auto vertices = fEvent->Primaries;
+    const auto trajs = fEvent.Trajectories();
+    const auto vertices = fEvent.Primaries();
     for(const auto& vtx: vertices)
     {
       for(const auto& prim: vtx.Particles)
@@ -301,46 +75,33 @@ namespace reco
 
         if(strcmp(name, "neutron") == 0 && mom.E()-mom.Mag() > fEMin) 
         {
-          truth::Descendants(primId, trajs, neutDescendIDs);
+          fTruth.Descendants(primId, neutDescendIDs);
           neutDescendIDs.insert(primId);
         }
         //else std::cout << "Primary named " << prim.Name << " with KE " << mom.E()-mom.Mag() << " is not a FS neutron.\n";
       }
     }
-    #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-    auto vertexPos = vertices[0].GetPosition();
-    #else
-	auto vertexPos = vertices[0].Position;
-    #endif	
-
-    TVector3 center(0., 0., 0.);
-    if(vertices.size() > 0) center = vertexPos.Vect();
 
     //Get geometry information for forming MCHits
     TGeoBBox hitBox(fWidth/2., fWidth/2., fWidth/2.);
 
     //Next, find all TG4HitSegments that are descended from an interesting FS particle.  
-    for(const auto& det: fEvent->SegmentDetectors) //Loop over sensitive detectors
+    for(size_t det = 0; det < fSegments.NDetectors(); ++det) //Loop over sensitive detectors
     {
-      //Decide on a threshold of when to use this algorithm?  
-      //Only sort energy deposits in this detector. 
-      //TODO: Come up with a reasoning for these thresholds
-      size_t subdiv = 0;
-      if(det.second.size() > 1e2) subdiv = 1;
-      if(det.second.size() > 1e3) subdiv = 2;
-      if(det.second.size() > 1e4) subdiv = 3;
-
-      //TODO: Only use neutGeom if there are lots of energy deposits from FS neutrons? 
-      ::XHemisphere neutGeom(center, 1000, subdiv), otherGeom(center, 1000, subdiv); //Split based on the first vertex in this event.  
+      //Sort this detector's TG4HitSegments into bounding volume hierarchies so that finding the ones near a seed 
+      //doesn't mean looking at all of them.  
+      fNeutronRows.clear();
+      fOtherRows.clear();
+      fNeutronBVH.clear();
+      fOtherBVH.clear();
 
       //Get geometry information about the detector of interest
-      //TODO: This is specfic to the files I am processing right now!
-      const std::string fiducial = "volA3DST_PV";
-      auto mat = geo::findMat(fiducial, *(fGeo->GetTopNode()));
-      auto shape = fGeo->FindVolumeFast(fiducial.c_str())->GetShape();
+      const auto& fiducial = fGeometry.Fiducial(); //Only looked up once per file
+      const auto shape = fiducial.Shape;
 
-      for(const auto& seg: det.second) //Loop over TG4HitSegments in this sensitive detector
+      for(size_t row = fSegments.DetectorBegin(det); row < fSegments.DetectorEnd(det); ++row) //Loop over TG4HitSegments in this sensitive detector
       {
+        const auto& seg = *(fSegments.Segment[row]);
         //Simple fiducial cut.  Should really look at how much of deposit is inside the fiducial volume or something.  
         //Ideally, I'll just get edepsim to do this for me in the future by creating a volume for each scintillator block.
         #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
@@ -353,30 +114,35 @@ namespace reco
         const int segPrim = seg.PrimaryId;
         #endif
   
-        const auto local = geo::InLocal((segStart.Vect()+segStop.Vect())*0.5, mat);
-        double arr[] = {local.X(), local.Y(), local.Z()};
-        if(shape->Contains(arr))
+        const double mid[] = {0.5*(fSegments.StartX[row]+fSegments.StopX[row]), 0.5*(fSegments.StartY[row]+fSegments.StopY[row]), 
+                              0.5*(fSegments.StartZ[row]+fSegments.StopZ[row])}; //Already in the detector's coordinate system
+        if(shape->Contains(mid))
         {
           //const auto primary = truth::Matriarch(seg, trajs);
           if(neutDescendIDs.count(segPrim))
           {
-            neutGeom[seg].push_back(seg);
+            fNeutronBVH.insert(fNeutronRows.size(), segStart.Vect(), segStop.Vect());
+            fNeutronRows.push_back(row);
           }
           else 
           {
-            otherGeom[seg].push_back(seg);
+            fOtherBVH.insert(fOtherRows.size(), segStart.Vect(), segStop.Vect());
+            fOtherRows.push_back(row);
           }
         }
       }
-
-      //Form MCHits from interesting TG4HitSegments
-      while(neutGeom.size() > 0)
+      fNeutronBVH.Build();
+      fOtherBVH.Build();
+
+      //Form MCHits from interesting TG4HitSegments.  Each neutron-descended TG4HitSegment that isn't already part of an 
+      //MCHit seeds a new MCHit.
+      fAbsorbed.assign(fNeutronRows.size(), false);
+      const TVector3 halfWidth(fWidth/2., fWidth/2., fWidth/2.);
+      for(size_t seedIndex = 0; seedIndex < fNeutronRows.size(); ++seedIndex)
       {
-        const TG4HitSegment seed = neutGeom.first(); //Make sure this is copied and not a reference since I am about to delete it
-
-        //Remove this and replace the std::lists above where neutGeom and otherGeom are defined to not use crazy geometry algorithm.  
-        auto& neutSegs = neutGeom[seed];
-        auto& others = otherGeom[seed]; 
+        if(fAbsorbed[seedIndex]) continue;
+        fAbsorbed[seedIndex] = true; //Make sure seed is not double-counted later
+        const auto& seed = *(fSegments.Segment[fNeutronRows[seedIndex]]);
 
         #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
         auto seedId = seed.GetPrimaryId();
@@ -394,77 +160,68 @@ namespace reco
         hit.Width = fWidth;
         hit.Position = seedStart;
 
-        TVector3 boxCenter = hit.Position.Vect();
-
-        neutSegs.erase(neutSegs.begin()); //remove the seed from the list of neutSegs so that it is not double-counted later.
-        //Now, try to never use seed again.  It's probably safe anyway if I copied it correctly, but I don't entirely trust myself. 
-
-        //Look for TG4HitSegments from neutrons that are inside hitBox
-        neutSegs.remove_if([&hit, &hitBox, &boxCenter, mat](auto& seg)
-                           {
-							 #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-							 const auto segStart = seg.GetStart();
-							 const auto segStop = seg.GetStop();
-							 const int segPrim = seg.GetPrimaryId();
-							 auto segEnergy = seg.GetEnergyDeposit();
-							 #else
-							 const auto segStart = seg.Start;
-							 const auto segStop = seg.Stop;
-							 const int segPrim = seg.PrimaryId;
-							 auto segEnergy = seg.EnergyDeposit;
-							 #endif
-                             //Find out how much of seg's total length is inside this box
-                             const double dist = geo::DistFromOutside(hitBox, segStart.Vect(),
-                                                                   segStop.Vect(), boxCenter);
+        const TVector3 boxCenter = hit.Position.Vect();
+
+        //Look for TG4HitSegments from neutrons that are inside hitBox.  Only the ones whose bounding boxes overlap 
+        //hitBox could be.  
+        fNeutronBVH.Overlaps(boxCenter - halfWidth, boxCenter + halfWidth, [this, &hit, &hitBox, &boxCenter](const size_t index)
+                             {
+                               if(fAbsorbed[index]) return;
+                               const auto& seg = *(fSegments.Segment[fNeutronRows[index]]);
+							   #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
+							   const auto segStart = seg.GetStart();
+							   const auto segStop = seg.GetStop();
+							   const int segPrim = seg.GetPrimaryId();
+							   auto segEnergy = seg.GetEnergyDeposit();
+							   #else
+							   const auto segStart = seg.Start;
+							   const auto segStop = seg.Stop;
+							   const int segPrim = seg.PrimaryId;
+							   auto segEnergy = seg.EnergyDeposit;
+							   #endif
+                               //Find out how much of seg's total length is inside this box
+                               const double dist = geo::DistFromOutside(hitBox, segStart.Vect(),
+                                                                     segStop.Vect(), boxCenter);
                                                                                                                                           
-                             if(dist > 0.0) return false; //If this segment is completely outside 
-                                                          //the box that contains seed, keep it for later.
+                               if(dist > 0.0) return; //If this segment is completely outside 
+                                                      //the box that contains seed, keep it for later.
                               
-                             //Otherwise, add this segments's energy to the MCHit
-                             hit.TrackIDs.push_back(segPrim); //This segment contributed something to this hit
-                             hit.Energy += segEnergy;
-                             //std::cout << "Accumulated another neutron seg's energy of " << seg.EnergyDeposit << "\n";
-                             //TODO: Energy-weighted position average
-  
-                             return true;
-                           }); //Looking for segments in the same box
+                               //Otherwise, add this segments's energy to the MCHit
+                               fAbsorbed[index] = true;
+                               hit.TrackIDs.push_back(segPrim); //This segment contributed something to this hit
+                               hit.Energy += segEnergy;
+                               //std::cout << "Accumulated another neutron seg's energy of " << seg.EnergyDeposit << "\n";
+                               //TODO: Energy-weighted position average
+                             }); //Looking for segments in the same box
     
         if(hit.Energy > fEMin)
         {    
           //Add up the non-neutron-descended energy deposits in this box.
           //At least do this calculation when I know what I'm looking for.  
           double otherE = 0.;
-          for(auto otherPtr = others.begin(); otherPtr != others.end() /*&& !(hit.Energy+10. > otherE*3.)*/; ++otherPtr) //Add an extra 10 MeV to be sure this is not 
-                                                                                                               //a floating point precision problem
+          fOtherBVH.Overlaps(boxCenter - halfWidth, boxCenter + halfWidth, [this, &otherE, &hitBox, &boxCenter](const size_t index)
           {
-            const auto& seg = *otherPtr;
+            const auto& seg = *(fSegments.Segment[fOtherRows[index]]);
             //TODO: Should these be InLocal()?
             //TODO: Use result of DistFromInside to figure out how much energy is contributed.
 			#ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
 		    const auto segStart = seg.GetStart();
 			const auto segStop = seg.GetStop();
-		    const int segEnergy = seg.GetEnergyDeposit();
+		    const auto segEnergy = seg.GetEnergyDeposit();
 		    #else
 		    const auto segStart = seg.Start;
 			const auto segStop = seg.Stop;
-		    const int segEnergy = seg.EnergyDeposit;
+		    const auto segEnergy = seg.EnergyDeposit;
 		    #endif
             if(geo::DistFromInside(hitBox, segStart.Vect(), segStop.Vect(), boxCenter) > 0.0)
             {
               otherE += segEnergy;
             }
-
-            //Simpler algorithm to check for segments that either start or end in this hit.
-            /*const auto startDiff = seg.Start.Vect()-boxCenter;
-            const auto stopDiff = seg.Stop.Vect()-boxCenter;
-            if(std::fabs(startDiff.X()) < fWidth || std::fabs(startDiff.Y()) < fWidth || std::fabs(startDiff.Z()) < fWidth) otherE += seg.EnergyDeposit;
-            else if(std::fabs(stopDiff.X()) < fWidth || std::fabs(stopDiff.Y()) < fWidth || std::fabs(stopDiff.Z()) < fWidth) otherE += seg.EnergyDeposit;*/
-
-          }
+          });
 
           if(hit.Energy > otherE*3.) fHits.push_back(hit);
         } //If hit is above energy threshold
-      } //While neutSegs is non-empty
+      } //For each seed
     } //For each SensDet
   
     return !(fHits.empty());
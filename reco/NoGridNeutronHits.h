@@ -6,6 +6,9 @@
 
 //EdepNeutrons includes
 #include "reco/Reconstructor.h"
+#include "reco/alg/SegmentTable.h"
+#include "reco/alg/SegmentBVH.h"
+#include "alg/TrajectoryIndex.h"
 #include "persistency/MCHit.h"
 
 #ifndef RECO_NOGRIDNEUTRONHITS_H
@@ -29,6 +32,16 @@ namespace reco
       double fWidth; //The width in mm of each dimension of a MCHit. 
       double fEMin; //The energy threshold in MeV for creating an MCHit.  Neutrons 
                     //with less than this amount of KE are not interesting to me.   
+
+      const SegmentTable& fSegments; //TG4HitSegments in the detector's coordinate system.  Shared with other plugins.
+      const truth::TrajectoryIndex& fTruth; //Which TG4Trajectories came from which.  Shared with other plugins.
+
+      //Kept between events so that they don't have to allocate memory again
+      std::vector<size_t> fNeutronRows; //SegmentTable rows of neutron-descended TG4HitSegments in the current detector
+      std::vector<size_t> fOtherRows; //SegmentTable rows of all other TG4HitSegments in the current detector
+      SegmentBVH fNeutronBVH; //Finds elements of fNeutronRows near a box
+      SegmentBVH fOtherBVH; //Finds elements of fOtherRows near a box
+      std::vector<bool> fAbsorbed; //Is each element of fNeutronRows already part of an MCHit?
   };
 }
 
@@ -4,21 +4,48 @@
 
 //local includes
 #include "reco/Reconstructor.h"
+#include "reco/alg/SegmentTable.h"
+
+//truth includes
+#include "alg/TrajectoryIndex.h"
 
 //ROOT includes
 #include "TTree.h"
 #include "TGeoManager.h"
-#include "TTreeReader.h"
 
 namespace plgn
 {
-  Reconstructor::Reconstructor(const Config& config): fEvent(*(config.Input), "Event"), fGeo(nullptr)
+  Reconstructor::Reconstructor(const Config& config): fEvent(*(config.CurrentEvent)), fGeo(nullptr), fGeometry(*(config.Geometry)), fOutput(config.Output), fProducts(*(config.Registry)), 
+                                                      fSegmentTable(*(config.Segments)), fTrajIndex(*(config.Truth)), fInputs(), fProduced(), fOutputs(), 
+                                                      fCompact(config.Options["Compact"] && config.Options["Compact"].as<bool>()), 
+                                                      fColumns(), fCompactors()
+  {
+  }
+
+  const reco::SegmentTable& Reconstructor::UseSegments()
+  {
+    DeclareInput("SegmentDetectors");
+    fSegmentTable.Request();
+    return fSegmentTable;
+  }
+
+  const truth::TrajectoryIndex& Reconstructor::UseTruth()
   {
+    DeclareInput("Trajectories");
+    fTrajIndex.Request();
+    return fTrajIndex;
   }
 
   bool Reconstructor::Reconstruct()
   {
     fGeo = gGeoManager; //TODO: Do I want to retrieve the TGeoManager from the current file instead?  
-    return DoReconstruct();
+    const bool found = DoReconstruct();
+    Compact();
+    return found;
+  }
+
+  void Reconstructor::Compact()
+  {
+    for(auto& compact: fCompactors) compact();
   }
 } 
@@ -3,19 +3,47 @@
 //       event came from.  
 //Author: Andrew Olivier aolivier@ur.rochester.edu
 
-//edepsim includes
-#include "TG4Event.h"
+//app includes
+#include "app/Event.h"
+#include "app/Products.h"
+
+//persistency includes
+#include "persistency/MCHitColumns.h"
+#include "persistency/MCClusterColumns.h"
 
 //yaml-cpp includes
 #include "yaml-cpp/yaml.h"
 
 //ROOT includes
-#include "TTreeReaderValue.h"
+#include "TTree.h"
+
+//c++ includes
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <utility>
+
+#ifndef PLGN_RECONSTRUCTOR_H
+#define PLGN_RECONSTRUCTOR_H
 
-class TTreeReader;
-class TTree;
 class TGeoManager;
 
+namespace geo
+{
+  class GeoService;
+}
+
+namespace reco
+{
+  class SegmentTable;
+}
+
+namespace truth
+{
+  class TrajectoryIndex;
+}
+
 namespace plgn
 {
   class Reconstructor
@@ -23,7 +51,11 @@ namespace plgn
     public:
       struct Config
       {
-        TTreeReader* Input;
+        const Event* CurrentEvent; //The TG4Event the driver application reads each entry into
+        Products* Registry; //Where to find other plugins' products and register my own
+        geo::GeoService* Geometry; //Volumes from the current file's TGeoManager, looked up only once per file
+        reco::SegmentTable* Segments; //Every TG4HitSegment in the current event in the fiducial volume's coordinate system
+        truth::TrajectoryIndex* Truth; //Family tree of the current event's TG4Trajectories
         TTree* Output;
         YAML::Node Options;
       };
@@ -33,11 +65,109 @@ namespace plgn
 
       bool Reconstruct(); //Public interface to private implementation
 
+      //Names of the branches this Reconstructor reads.  The parts of the TG4Event it needs are named Primaries, Trajectories, 
+      //and SegmentDetectors.  RunId and EventId are always available.  The driver application doesn't read anything else.
+      const std::vector<std::string>& Inputs() const { return fInputs; }
+
+      //Names of the products this Reconstructor makes that other plugins can Consume()
+      const std::vector<std::string>& Produced() const { return fProduced; }
+
+      //Names of the branches this Reconstructor writes.  With Compact: true, MCHits and MCClusters are written to a branch 
+      //named <product>Columns instead of <product>.
+      const std::vector<std::string>& Outputs() const { return fOutputs; }
+
+      //Description and value of each thing this Reconstructor counts over a whole job, like how often it had to fall back
+      //to a cheaper algorithm.  The driver application adds these up over every Worker and prints them at the end of the
+      //job.  Must always return the same descriptions in the same order.
+      using Counters = std::vector<std::pair<std::string, size_t>>;
+      virtual Counters Stats() const { return Counters(); }
+
+      //Copy Produce()d MCHits and MCClusters into the columns that are written instead of them when this Reconstructor 
+      //is configured with Compact: true.  Reconstruct() already does this.  The driver application also calls it after 
+      //emptying products for an entry that this Reconstructor never saw.
+      void Compact();
+
     protected:
       virtual bool DoReconstruct() = 0; //Look at what is already in the tree and do your own reconstruction.
 
-      TTreeReaderValue<TG4Event> fEvent; //Access to the "current" TG4Event.  You'll just have to trust the driver application.
+      //Derived classes should call these in their constructors to tell the driver application what they need.
+      void DeclareInput(const std::string& branch) { fInputs.push_back(branch); }
+
+      //Read another Reconstructor's products.  If no Reconstructor in this job makes branch, it is read from the input file.
+      //A Reconstructor that Consume()s a branch always runs after the Reconstructor that Produce()s it.
+      template <class T>
+      Handle<T> Consume(const std::string& branch)
+      {
+        DeclareInput(branch);
+        return fProducts.Consume<T>(branch);
+      }
+
+      //Write product to the output TTree as branch and let other plugins Consume() it.
+      template <class T>
+      void Produce(const std::string& branch, std::vector<T>& product)
+      {
+        fProduced.push_back(branch);
+        Write(branch, product);
+        fProducts.Produce(branch, product);
+      }
+
+      //Ask the driver application to fill a SegmentTable for every event and get read-only access to it.  Call this 
+      //in a derived class's constructor.  Also declares SegmentDetectors as an input.  Filters run before the 
+      //SegmentTable is filled, so they can't use it.  
+      const reco::SegmentTable& UseSegments();
+
+      //Ask the driver application to index the current event's TG4Trajectories by parent and get read-only access to 
+      //that index.  Call this in a derived class's constructor.  Also declares Trajectories as an input.
+      const truth::TrajectoryIndex& UseTruth();
+
+      const Event& fEvent; //Access to the "current" TG4Event.  You'll just have to trust the driver application.
       TGeoManager* fGeo; //Access to the "current" TGeoManager.  Since I might want to change it at some point, setting it from 
                          //this base class.
+      geo::GeoService& fGeometry; //Look up volumes here instead of walking fGeo's nodes on every event
+
+    private:
+      TTree* fOutput; //Where Produce()d branches go
+      Products& fProducts; //Where Consume()d branches come from
+      reco::SegmentTable& fSegmentTable; //Filled by the driver application once per event if any plugin UseSegments()
+      truth::TrajectoryIndex& fTrajIndex; //Filled by the driver application once per event if any plugin UseTruth()
+      std::vector<std::string> fInputs; //Branches I read
+      std::vector<std::string> fProduced; //Products other plugins can Consume() from me
+      std::vector<std::string> fOutputs; //Branches I write
+
+      //Optional compact output for MCHits and MCClusters.  Other plugins in the same job still Consume() the std::vectors.
+      bool fCompact; //Write MCHits and MCClusters as MCHitColumns and MCClusterColumns in branches named <branch>Columns?
+      std::vector<std::unique_ptr<TObject>> fColumns; //What compact branches point to
+      std::vector<std::function<void()>> fCompactors; //Fill each element of fColumns from its product
+
+      //Make a branch for product in the output TTree
+      template <class T>
+      void Write(const std::string& branch, std::vector<T>& product)
+      {
+        fOutputs.push_back(branch);
+        fOutput->Branch(branch.c_str(), &product);
+      }
+
+      //MCHits and MCClusters can be written as columns instead
+      void Write(const std::string& branch, std::vector<pers::MCHit>& product) { WriteColumns<pers::MCHitColumns>(branch, product); }
+      void Write(const std::string& branch, std::vector<pers::MCCluster>& product) { WriteColumns<pers::MCClusterColumns>(branch, product); }
+
+      template <class COLUMNS, class T>
+      void WriteColumns(const std::string& branch, std::vector<T>& product)
+      {
+        if(!fCompact) 
+        {
+          fOutputs.push_back(branch);
+          fOutput->Branch(branch.c_str(), &product);
+          return;
+        }
+
+        auto columns = new COLUMNS();
+        fColumns.emplace_back(columns);
+        fOutputs.push_back(branch+"Columns");
+        fOutput->Branch(fOutputs.back().c_str(), columns);
+        fCompactors.push_back([columns, &product]() { columns->Fill(product); });
+      }
   };
 }
+
+#endif //PLGN_RECONSTRUCTOR_H
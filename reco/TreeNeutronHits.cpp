@@ -15,14 +15,15 @@
 #include "TGeoNode.h"
 #include "TGeoVolume.h"
 #include "TGeoBBox.h"
+#include "TTree.h"
 
 //EdepNeutrons includes
 #include "reco/TreeNeutronHits.h"
-#include "reco/alg/Octree.cpp"
 #include "persistency/MCHit.h"
 #include "app/Factory.cpp"
 #include "reco/alg/GeoFunc.h"
-#include "alg/TruthFunc.h"
+#include "reco/alg/GeoService.h"
+#include "reco/alg/SegmentTable.h"
 
 //c++ includes
 #include <set>
@@ -30,18 +31,21 @@
 
 namespace reco
 {
-  TreeNeutronHits::TreeNeutronHits(const plgn::Reconstructor::Config& config): plgn::Reconstructor(config), fHits(), fEMin(2.)
+  TreeNeutronHits::TreeNeutronHits(const plgn::Reconstructor::Config& config): plgn::Reconstructor(config), fHits(), fEMin(2.), 
+                                                                               fLeafDepth(config.Options["LeafDepth"].as<size_t>()), 
+                                                                               fSegments(UseSegments()), fTruth(UseTruth()),
+                                                                               fNeutronTree(TVector3(), TVector3(), 0), fOtherTree(TVector3(), TVector3(), 0)
   {
     //TODO: Rewrite interface to allow configuration?  Maybe pass in opt::CmdLine in constructor, then 
     //      reconfigure from opt::Options after Parse() was called? 
 
-    config.Output->Branch("TreeNeutronHits", &fHits);
+    Produce("TreeNeutronHits", fHits);
+    DeclareInput("Primaries");
   }
 
   //Produce MCHits from TG4HitSegments descended from FS neutrons above threshold
   bool TreeNeutronHits::DoReconstruct() 
   {
-    std::cout << "Entering TreeNeutronHits::DoReconstruct()\n";
     //Get rid of the previous event's MCHits
     fHits.clear();
 
@@ -49,8 +53,8 @@ namespace reco
     //First, figure out which TG4Trajectories are descendants of particles I am interested in.  
     //I am interested in primary neutrons with > 2 MeV KE. 
     std::set<int> neutDescendIDs; //TrackIDs of FS neutron descendants
-    const auto trajs = fEvent->Trajectories;
-    const auto vertices = fEvent->Primaries;
+    const auto trajs = fEvent.Trajectories();
+    const auto vertices = fEvent.Primaries();
     for(const auto& vtx: vertices)
     {
       for(const auto& prim: vtx.Particles)
@@ -67,7 +71,7 @@ namespace reco
 
         if(strcmp(name, "neutron") == 0 && mom.E()-mom.Mag() > fEMin) 
         {
-          truth::Descendants(primId, trajs, neutDescendIDs);
+          fTruth.Descendants(primId, neutDescendIDs);
           neutDescendIDs.insert(primId);
         }
         //else std::cout << "Primary named " << prim.Name << " with KE " << mom.E()-mom.Mag() << " is not a FS neutron.\n";
@@ -75,25 +79,25 @@ namespace reco
     }
     if(neutDescendIDs.empty()) return false; //If there are no neutron-descneded hits in this event, there is nothing to do.
 
-    std::cout << "Entering loop over SensDets.\n";
     //Next, find all TG4HitSegments that are descended from an interesting FS particle.  
-    for(const auto& det: fEvent->SegmentDetectors) //Loop over sensitive detectors
+    for(size_t det = 0; det < fSegments.NDetectors(); ++det) //Loop over sensitive detectors
     {
       //Get geometry information about the detector of interest
       //TODO: This is specfic to the files I am processing right now!
-      const std::string fiducial = "volA3DST_PV";
-      auto mat = geo::findMat(fiducial, *(fGeo->GetTopNode()));
-      auto shape = fGeo->FindVolumeFast(fiducial.c_str())->GetShape();
+      const auto& fiducial = fGeometry.Fiducial(); //Only looked up once per file
+      const auto mat = &fiducial.Matrix;
+      const auto shape = fiducial.Shape;
 
-      //Group energy deposits into "subdetectors"
+      //Group energy deposits into "subdetectors".  Every event uses the same depth so that MCHits are always the same size.  
+      //The box is a cube so that MCHits are cubes.  
       const auto center = geo::InGlobal(TVector3(0., 0., 0.), mat); //Find the center of this detector
-      Octree<pers::MCHit, 6> neutGeom(center, TVector3(1200, 1200, 1000)); //TODO: Get half-width as a TVector3 to form a box instead of a cube 
-      std::cout << "Created neutGeom.\n";
-      Octree<double, 6> otherGeom(center, TVector3(1200, 1200, 1000));
-      std::cout << "Succeeded in creating Octrees.\n";
+      const TVector3 halfWidth(1200, 1200, 1200); //TODO: Get half-width from the fiducial volume's shape
+      fNeutronTree.Reset(center, halfWidth, fLeafDepth);
+      fOtherTree.Reset(center, halfWidth, fLeafDepth);
 
-      for(const auto& seg: det.second) //Loop over TG4HitSegments in this sensitive detector
+      for(size_t row = fSegments.DetectorBegin(det); row < fSegments.DetectorEnd(det); ++row) //Loop over TG4HitSegments in this sensitive detector
       {
+        const auto& seg = *(fSegments.Segment[row]);
         //Simple fiducial cut.  Should really look at how much of deposit is inside the fiducial volume or something.  
         //Ideally, I'll just get edepsim to do this for me in the future by creating a volume for each scintillator block. 
 		#ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
@@ -108,46 +112,49 @@ namespace reco
 		auto segEnergy = seg.EnergyDeposit;
         #endif
 
-        const auto local = geo::InLocal((segStart.Vect()+segStop.Vect())*0.5, mat);
-        double arr[] = {local.X(), local.Y(), local.Z()};
-        if(shape->Contains(arr))
+        const double mid[] = {0.5*(fSegments.StartX[row]+fSegments.StopX[row]), 0.5*(fSegments.StartY[row]+fSegments.StopY[row]), 
+                              0.5*(fSegments.StartZ[row]+fSegments.StopZ[row])}; //Already in the detector's coordinate system
+        if(shape->Contains(mid))
         {
+          //Share this TG4HitSegment's energy between the leaves it passes through by how much of its length is in each one
+          const double t0 = segStart.T(), dt = segStop.T() - segStart.T();
           if(neutDescendIDs.count(segPrim))
           {
-            const auto center = (segStart+segStop).Vect()*0.5; //TODO: Really, an Octree that knows to split TG4HitSegments would be ideal here
-            auto pair = neutGeom[center];
-            if(!pair.second) 
-            {
-              pair.second = new pers::MCHit();
-              pair.second->Position = TLorentzVector(pair.first.X(), pair.first.Y(), pair.first.Z(), segStart.T());
-            }
-
-            auto& hit = *(pair.second);
-            hit.Energy += segEnergy;
-            hit.TrackIDs.push_back(segPrim);
+            fNeutronTree.Segment(segStart.Vect(), segStop.Vect(), [&](const TVector3& center, pers::MCHit& hit, const double enter, const double exit)
+                                 {
+                                   if(hit.TrackIDs.empty()) //This is a new MCHit
+                                   {
+                                     hit.Energy = 0.;
+                                     hit.Width = fNeutronTree.LeafWidth(0);
+                                     hit.Position = TLorentzVector(center.X(), center.Y(), center.Z(), 0.);
+                                   }
+
+                                   const double edep = segEnergy*(exit - enter);
+                                   hit.Energy += edep;
+                                   hit.Position.SetT(hit.Position.T() + edep*(t0 + dt*0.5*(enter + exit))); //Energy-weighted sum of times for now
+                                   hit.TrackIDs.push_back(segPrim);
+                                 });
           }
           else 
           {
-            auto ptr = otherGeom[(segStart+segStop).Vect()*0.5].second;
-            if(!ptr) ptr = new double();
-            auto& edep = *ptr;
-            edep += segEnergy;
+            fOtherTree.Segment(segStart.Vect(), segStop.Vect(), [segEnergy](const TVector3&, double& energy, const double enter, const double exit)
+                               {
+                                 energy += segEnergy*(exit - enter);
+                               });
           }
         }
       }
 
       //Write MCHits that pass cuts to this event
-      neutGeom.visitor([&otherGeom, this](const auto ptr)
-                       {
-                         if(ptr) //Ignore empty (= uninitialized) cells
-                         {
-                           auto& hit = *ptr; 
-                           double otherE = 0.;
-                           auto otherPtr = otherGeom[hit.Position.Vect()].second;
-                           if(otherPtr) otherE = *otherPtr;
-                           if(hit.Energy > 3.*otherE && hit.Energy > fEMin) this->fHits.push_back(hit);
-                         }
-                       }); 
+      fNeutronTree.visitor([this](const auto ptr)
+                           {
+                             auto& hit = *ptr; 
+                             if(hit.Energy > 0.) hit.Position.SetT(hit.Position.T()/hit.Energy); //Energy-weighted average time
+                             double otherE = 0.;
+                             auto otherPtr = fOtherTree.find(hit.Position.Vect());
+                             if(otherPtr) otherE = *otherPtr;
+                             if(hit.Energy > 3.*otherE && hit.Energy > fEMin) this->fHits.push_back(hit);
+                           }); 
     } //For each SensDet
 
 
@@ -6,6 +6,9 @@
 
 //EdepNeutrons includes
 #include "reco/Reconstructor.h"
+#include "reco/alg/SegmentTable.h"
+#include "reco/alg/Octree.h"
+#include "alg/TrajectoryIndex.h"
 #include "persistency/MCHit.h"
 
 #ifndef RECO_TREENEUTRONHITS_H
@@ -28,6 +31,14 @@ namespace reco
       //Parameters that I will refer to
       double fEMin; //The energy threshold in MeV for creating an MCHit.  Neutrons 
                     //with less than this amount of KE are not interesting to me.   
+      size_t fLeafDepth; //Leaves of fNeutronTree are 2^-fLeafDepth of the detector wide.  Sets the width of every MCHit.
+
+      const SegmentTable& fSegments; //TG4HitSegments in the detector's coordinate system.  Shared with other plugins.
+      const truth::TrajectoryIndex& fTruth; //Which TG4Trajectories came from which.  Shared with other plugins.
+
+      //Energy deposits grouped into "subdetectors".  Reset for each sensitive detector, but the memory is kept between events.  
+      Octree<pers::MCHit> fNeutronTree; //MCHits from ancestors of FS neutrons
+      Octree<double> fOtherTree; //Energy from everything else
   };
 }
 
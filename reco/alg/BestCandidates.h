@@ -0,0 +1,153 @@
+//File: BestCandidates.h
+//Brief: BestCandidates groups clusters into neutron candidates the way CandFromPDF does.  Each cluster is in a time bin
+//       and has a log-likelihood term.  A candidate has either one cluster or nothing from each time bin, and its
+//       log-likelihood is the sum of its clusters' terms plus a penalty for each time bin it leaves out.  Candidates are
+//       found one at a time, most likely first, until every cluster is in one.
+//
+//       CandFromPDF used to try every combination of clusters for each candidate.  Since the terms are independent, the
+//       most likely candidate takes the best remaining cluster from each time bin whose best cluster beats the penalty.
+//       If no time bin's best cluster beats the penalty, it's the single cluster that loses the least compared to the
+//       penalty because a candidate must have at least one cluster.  When there are ties, this picks the same candidate
+//       as trying every combination of clusters in order.  A NaN term never wins.
+//
+//       Each candidate costs one pass over the time bins.  If that adds up to more than a work budget in one event, the
+//       rest of the clusters are grouped greedily instead: the best remaining cluster from every time bin, even if
+//       leaving that bin out would be more likely.  Keeps all memory around between events.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//c++ includes
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstddef>
+
+#ifndef RECO_BESTCANDIDATES_H
+#define RECO_BESTCANDIDATES_H
+
+namespace reco
+{
+  class BestCandidates
+  {
+    public:
+      BestCandidates(const size_t workBudget): fWorkBudget(workBudget), fNFallbacks(0), fTerms(), fTimeBins(), fOrder(), fBins(),
+                                               fChosen(), fCand() {}
+      virtual ~BestCandidates() = default;
+
+      //Start a new event
+      void clear()
+      {
+        fTerms.clear();
+        fTimeBins.clear();
+      }
+
+      //Add the next cluster.  Clusters are numbered in the order they're added.
+      void Add(const double term, const unsigned int timeBin)
+      {
+        fTerms.push_back(std::isnan(term)?-std::numeric_limits<double>::infinity():term); //A NaN term never wins
+        fTimeBins.push_back(timeBin);
+      }
+
+      //Call make(const std::vector<size_t>& clusters) with each candidate's clusters in time order, most likely candidate
+      //first, until every cluster added since clear() is in a candidate.  penalty is the term for a time bin that a
+      //candidate leaves out.  Returns whether the work budget ran out.
+      template <class FUNC>
+      bool Find(const double penalty, FUNC&& make)
+      {
+        //Sort clusters by time bin.  Within each bin, put the clusters that contribute the most to a likelihood first.
+        //Clusters with the same term stay in the order they were added.
+        fOrder.resize(fTerms.size());
+        for(size_t cluster = 0; cluster < fOrder.size(); ++cluster) fOrder[cluster] = cluster;
+        std::sort(fOrder.begin(), fOrder.end(), [this](const size_t first, const size_t second)
+                                                {
+                                                  if(fTimeBins[first] != fTimeBins[second]) return fTimeBins[first] < fTimeBins[second];
+                                                  if(fTerms[first] != fTerms[second]) return fTerms[first] > fTerms[second];
+                                                  return first < second;
+                                                });
+
+        //Ranges in fOrder of clusters from each time bin that aren't in a candidate yet
+        fBins.clear();
+        for(size_t pos = 0; pos < fOrder.size(); ++pos)
+        {
+          if(pos == 0 || fTimeBins[fOrder[pos]] != fTimeBins[fOrder[pos-1]]) fBins.emplace_back(pos, pos);
+          fBins.back().second = pos+1;
+        }
+
+        size_t work = 0;
+        bool greedy = false;
+        for(;;)
+        {
+          fChosen.clear();
+          work += fBins.size();
+          if(!greedy && work > fWorkBudget)
+          {
+            greedy = true;
+            ++fNFallbacks;
+          }
+
+          if(greedy) //The best remaining cluster from every time bin, even if leaving that bin out would be more likely
+          {
+            for(size_t bin = 0; bin < fBins.size(); ++bin) if(!Empty(bin)) fChosen.push_back(bin);
+          }
+          else
+          {
+            for(size_t bin = 0; bin < fBins.size(); ++bin)
+            {
+              if(!Empty(bin) && Best(bin) >= penalty) fChosen.push_back(bin);
+            }
+
+            if(fChosen.empty()) //Leaving out every time bin would be best, but a candidate needs a cluster
+            {
+              double bestLoss = -std::numeric_limits<double>::infinity();
+              size_t best = 0;
+              bool found = false;
+              for(size_t bin = 0; bin < fBins.size(); ++bin)
+              {
+                if(!Empty(bin) && (!found || Best(bin) > bestLoss))
+                {
+                  best = bin;
+                  bestLoss = Best(bin);
+                  found = true;
+                }
+              }
+              if(!found) break; //No clusters left
+
+              if(bestLoss > -std::numeric_limits<double>::infinity()) fChosen.push_back(best);
+              else //Every candidate is impossible according to the terms.  Take the first cluster from each time bin.
+              {
+                for(size_t bin = 0; bin < fBins.size(); ++bin) if(!Empty(bin)) fChosen.push_back(bin);
+              }
+            }
+          }
+          if(fChosen.empty()) break; //No clusters left
+
+          //Remove these clusters from consideration for other candidates.  They're always the first remaining cluster in their bins.
+          fCand.clear();
+          for(const auto bin: fChosen) fCand.push_back(fOrder[fBins[bin].first++]);
+          make(fCand);
+        }
+
+        return greedy;
+      }
+
+      //Number of events in which the work budget ran out
+      size_t NFallbacks() const { return fNFallbacks; }
+
+    private:
+      size_t fWorkBudget; //Number of time bins to look at per event before grouping the rest of the clusters greedily
+      size_t fNFallbacks; //Number of events in which the remaining clusters were grouped greedily
+
+      std::vector<double> fTerms; //Log-likelihood term for each cluster.  NaN is replaced by -infinity.
+      std::vector<unsigned int> fTimeBins; //Time bin of each cluster
+      std::vector<size_t> fOrder; //Clusters sorted by time bin, then by term from largest to smallest
+      std::vector<std::pair<size_t, size_t>> fBins; //Range in fOrder of each time bin's clusters that aren't in a candidate yet
+      std::vector<size_t> fChosen; //Time bins that the next candidate uses
+      std::vector<size_t> fCand; //Clusters in the next candidate
+
+      bool Empty(const size_t bin) const { return fBins[bin].first == fBins[bin].second; }
+      double Best(const size_t bin) const { return fTerms[fOrder[fBins[bin].first]]; }
+  };
+}
+
+#endif //RECO_BESTCANDIDATES_H
@@ -0,0 +1,65 @@
+//File: DisjointSets.h
+//Brief: DisjointSets is a union-find structure over the integers [0, size()).  It groups elements into connected
+//       components one edge at a time in nearly constant time per edge.  Reconstructors use it to find groups of hits
+//       that touch each other without looping over every hit in a group each time 2 groups meet.  Everything is
+//       stored in flat std::vectors that Reset() reuses between events.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//c++ includes
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+#ifndef RECO_DISJOINTSETS_H
+#define RECO_DISJOINTSETS_H
+
+namespace reco
+{
+  class DisjointSets
+  {
+    public:
+      DisjointSets(): fParent(), fSize() {}
+      virtual ~DisjointSets() = default;
+
+      //Start over with nElements elements that are each in their own set
+      void Reset(const size_t nElements)
+      {
+        fParent.resize(nElements);
+        for(size_t elem = 0; elem < nElements; ++elem) fParent[elem] = elem;
+        fSize.assign(nElements, 1);
+      }
+
+      //Representative element of the set that elem is in.  Shortens paths to the representative as it goes.
+      size_t Find(size_t elem)
+      {
+        while(fParent[elem] != elem)
+        {
+          fParent[elem] = fParent[fParent[elem]];
+          elem = fParent[elem];
+        }
+        return elem;
+      }
+
+      //Put first and second in the same set.  Returns the new set's representative.
+      size_t Union(const size_t first, const size_t second)
+      {
+        size_t big = Find(first), small = Find(second);
+        if(big == small) return big;
+        if(fSize[big] < fSize[small]) std::swap(big, small);
+        fParent[small] = big;
+        fSize[big] += fSize[small];
+        return big;
+      }
+
+      //Number of elements in elem's set
+      size_t SetSize(const size_t elem) { return fSize[Find(elem)]; }
+
+      size_t size() const { return fParent.size(); }
+
+    private:
+      std::vector<size_t> fParent; //Each element's parent.  Representatives are their own parents.
+      std::vector<size_t> fSize; //Number of elements in each representative's set
+  };
+}
+
+#endif //RECO_DISJOINTSETS_H
@@ -29,7 +29,7 @@ namespace geo
     return nullptr;
   }
 
-  TVector3 InLocal(const TVector3& pos, TGeoMatrix* mat)
+  TVector3 InLocal(const TVector3& pos, const TGeoMatrix* mat)
   {
     double master[3] = {}, local[3] = {};
     pos.GetXYZ(master);
@@ -37,7 +37,7 @@ namespace geo
     return TVector3(local[0], local[1], local[2]);
   }
 
-  TVector3 InGlobal(const TVector3& pos, TGeoMatrix* mat)
+  TVector3 InGlobal(const TVector3& pos, const TGeoMatrix* mat)
   {
     double master[3] = {}, local[3] = {};
     pos.GetXYZ(local);
@@ -19,13 +19,14 @@ class TGeoShape;
 namespace geo
 {
   //Return the product of the matrices from the node with a volume called name with all of its' ancestors.
+  //Walks the whole TGeoNode tree and allocates a new matrix every time.  Plugins should use GeoService::Find() instead.
   TGeoMatrix* findMat(const std::string& name, TGeoNode& parent);
                                                                                                                           
   //Convert a 3-vector from a global position to the local coordinate system described by mat
-  TVector3 InLocal(const TVector3& pos, TGeoMatrix* mat);
+  TVector3 InLocal(const TVector3& pos, const TGeoMatrix* mat);
                                                                                                                           
   //The opposite of InLocal
-  TVector3 InGlobal(const TVector3& pos, TGeoMatrix* mat);
+  TVector3 InGlobal(const TVector3& pos, const TGeoMatrix* mat);
                                                                 
   //Finds the distance until leaving a boundary of shape for a line from begin to end.  Begin must be inside shape.                 
   double DistFromInside(const TGeoShape& shape, const TVector3& begin, const TVector3& end, const TVector3& shapeCenter);
@@ -0,0 +1,73 @@
+//File: GeoService.cpp
+//Brief: A GeoService finds named volumes in the current TGeoManager once and remembers them.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//Include header
+#include "reco/alg/GeoService.h"
+
+//util includes
+#include "Base/exception.h"
+
+//ROOT includes
+#include "TGeoManager.h"
+#include "TGeoNode.h"
+#include "TGeoVolume.h"
+
+namespace geo
+{
+  GeoService::GeoService(const std::string& fiducial): fGeo(nullptr), fFiducialName(fiducial), fVolumes(), fMutex()
+  {
+  }
+
+  void GeoService::SetGeometry(TGeoManager* geo)
+  {
+    //Even if geo is the same pointer, it might be a new TGeoManager that was allocated where the last one was.  
+    //Looking volumes up again once per file is cheap.
+    std::lock_guard<std::mutex> lock(fMutex);
+    fGeo = geo;
+    fVolumes.clear();
+  }
+
+  const GeoService::Volume& GeoService::Find(const std::string& name)
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    const auto found = fVolumes.find(name);
+    if(found != fVolumes.end()) return *(found->second);
+
+    if(!fGeo) throw util::exception("GeoService") << "Asked for volume " << name << " before there was a TGeoManager to look in.\n";
+
+    const auto vol = fGeo->FindVolumeFast(name.c_str());
+    std::unique_ptr<Volume> result(new Volume());
+    if(!vol || !Compose(name, *(fGeo->GetTopNode()), result->Matrix))
+    {
+      throw util::exception("GeoService") << "Could not find a volume named " << name << " in TGeoManager " << fGeo->GetName() << ".\n";
+    }
+    result->Shape = vol->GetShape();
+
+    return *(fVolumes.emplace(name, std::move(result)).first->second);
+  }
+
+  bool GeoService::Compose(const std::string& name, const TGeoNode& node, TGeoHMatrix& mat) const
+  {
+    if(std::string(node.GetVolume()->GetName()) == name)
+    {
+      mat = TGeoHMatrix(*(node.GetMatrix()));
+      return true;
+    }
+
+    const auto children = node.GetNodes();
+    if(!children) return false; //Leaf nodes don't have a list of daughters at all
+
+    for(auto child: *children)
+    {
+      if(Compose(name, *((TGeoNode*)child), mat))
+      {
+        TGeoHMatrix total(*(node.GetMatrix()));
+        total.Multiply(&mat);
+        mat = total;
+        return true;
+      }
+    }
+    return false;
+  }
+}
@@ -0,0 +1,71 @@
+//File: GeoService.h
+//Brief: A GeoService finds named volumes in the current TGeoManager and remembers where they are.  Looking up a volume 
+//       walks the whole TGeoNode tree, so plugins that used to call geo::findMat() on every event spent a lot of time 
+//       rediscovering the same matrix.  A GeoService only looks each volume up once per TGeoManager, and it owns 
+//       the matrices it makes so that nothing leaks.  
+//
+//       The driver application owns the GeoService and tells it about each new file's TGeoManager with SetGeometry().  
+//       Reconstructors get a GeoService through plgn::Reconstructor::Config.  Every Reconstructor in a Worker shares the 
+//       same GeoService, and a Worker might run several of them at the same time, so Find() is safe to call from more 
+//       than one thread.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//ROOT includes
+#include "TGeoMatrix.h"
+
+//c++ includes
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#ifndef GEO_GEOSERVICE_H
+#define GEO_GEOSERVICE_H
+
+class TGeoManager;
+class TGeoShape;
+class TGeoNode;
+
+namespace geo
+{
+  class GeoService
+  {
+    public:
+      //Where a volume is and what it looks like
+      struct Volume
+      {
+        TGeoHMatrix Matrix; //Product of this volume's matrix with the matrices of all of its ancestors.  Converts to and from the 
+                            //top volume's coordinate system.  
+        const TGeoShape* Shape; //Observer pointer.  Owned by the TGeoManager.
+      };
+
+      //fiducial is the name of the volume most plugins use for fiducial cuts and as the coordinate system for hits.
+      GeoService(const std::string& fiducial);
+      virtual ~GeoService() = default;
+
+      //Forget every volume I looked up before and use geo from now on.  Call this whenever the TGeoManager might change, 
+      //like when the driver application opens a new file.  
+      void SetGeometry(TGeoManager* geo);
+
+      //Look up a volume by name.  Only walks the TGeoNode tree the first time name is asked for with the current 
+      //TGeoManager.  Throws a util::exception if there is no volume called name.  Thread-safe.  
+      const Volume& Find(const std::string& name);
+
+      //The volume named in the configuration for fiducial cuts
+      const Volume& Fiducial() { return Find(fFiducialName); }
+      const std::string& FiducialName() const { return fFiducialName; }
+
+    private:
+      //Set mat to the product of the matrices from the node with a volume called name up to and including node.  
+      //Returns false if there is no volume called name under node.  Like geo::findMat(), but doesn't leak.  
+      bool Compose(const std::string& name, const TGeoNode& node, TGeoHMatrix& mat) const;
+
+      TGeoManager* fGeo; //Observer pointer to the TGeoManager volumes are looked up in
+      const std::string fFiducialName; //Name of the volume Fiducial() returns
+      std::map<std::string, std::unique_ptr<Volume>> fVolumes; //Volumes I have already looked up.  unique_ptr so that 
+                                                               //references from Find() stay valid.
+      std::mutex fMutex; //Guards fVolumes.  Reconstructors running at the same time might look up new volumes.
+  };
+}
+
+#endif //GEO_GEOSERVICE_H
@@ -5,14 +5,16 @@
 
 //local includes
 #include "reco/alg/GeoFunc.h"
+#include "reco/alg/VoxelMap.h"
+#include "reco/alg/LocalSegment.h"
 #include "persistency/MCHit.h"
 
-//ROOT includes
-#include "TGeoBBox.h"
-
 //c++ includes
 #include <iostream>
 #include <random>
+#include <limits>
+#include <cmath>
+#include <algorithm>
 
 #ifndef RECO_GRIDHITS_H
 #define RECO_GRIDHITS_H
@@ -30,7 +32,7 @@ namespace reco
   { 
     public: 
       //Elements of the public interface that the user will interact with
-      //3 indices combined into one to be used as an index to a std::map.  Indices can be negative so that I can reconstitute positions 
+      //3 indices combined into one to be used as an index to a VoxelMap.  Indices can be negative so that I can reconstitute positions 
       //more easily.  Proxy for position the way it is used here.
       class Triple
       {
@@ -51,7 +53,7 @@ namespace reco
           int Third;
       };
   
-      //The data I actually need to save for each MCHit.  The constructor default goes well with std::map::operator[].
+      //The data I actually need to save for each MCHit.  The constructor default goes well with VoxelMap::operator[].
       struct HitData
       {
         HitData(): Energy(0.), OtherE(0.), Time(0.), TrackIDs(), NContrib(0) {}
@@ -64,91 +66,128 @@ namespace reco
         size_t NContrib;
       };
 
+      //Sparse grid of HitData.  Keep one around between events so that it doesn't have to allocate memory again.
+      using HitMap = VoxelMap<Triple, HitData>;
+
       GridHits(const double width, const bool useSecond, const double timeRes);
       virtual ~GridHits() = default;
 
       //Public interface
       //Update a map from Triple (= position) to data to make an MCHit.
       template <class FUNC>
-      void MakeHitData(const TG4HitSegment& seg, std::map<Triple, HitData>& hitMap, TGeoMatrix* mat, FUNC&& pred) const      
+      void MakeHitData(const TG4HitSegment& seg, HitMap& hitMap, const TGeoMatrix* mat, FUNC&& pred) const      
+      {
+        MakeHitData(seg, LocalSegment(seg, mat), hitMap, std::forward<FUNC>(pred));
+      }
+
+      //Same as above for a segment that the caller already converted to the detector's coordinate system.
+      template <class FUNC>
+      void MakeHitData(const TG4HitSegment& seg, const LocalSegment& local, HitMap& hitMap, FUNC&& pred) const
       {
         //Next, add each segment to the hit(s) it enters.  This way, I loop over each segment exactly once.
         //Not actually storing all of the data for an MCHit because Width is the same for all MCHits made by this algorithm 
         //and Position can be reconstituted from a Triple key. 
-        TVector3 center(0., 0., 0.);
-    
-        //Fiducial cut
         #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
-        const auto segStart = seg.GetStart();
-		const auto segStop = seg.GetStop();
         const int segPrim = seg.GetPrimaryId();
 		auto segEnergy = seg.GetEnergyDeposit();
 		auto segSecondary = seg.GetSecondaryDeposit();
         #else
-        const auto segStart = seg.Start;
-		const auto segStop = seg.Stop;
         const int segPrim = seg.PrimaryId;
 		auto segEnergy = seg.EnergyDeposit;
 		auto segSecondary = seg.SecondaryDeposit;
         #endif
 
-        const auto start = geo::InLocal(segStart.Vect(), mat);
-        const auto stop = geo::InLocal(segStop.Vect(), mat);
-        const auto xCond = std::minmax({start.X(), stop.X()});
-        const auto yCond = std::minmax({start.Y(), stop.Y()});
-        const auto zCond = std::minmax({start.Z(), stop.Z()});
-        for(double boxX = (std::floor(xCond.first/fWidth)+0.5)*fWidth; boxX < (std::floor(xCond.second/fWidth)+1.0)*fWidth; boxX += fWidth)
+        const double length = local.Length;
+
+        //Only visit the cubes this segment actually passes through instead of every cube in its bounding box
+        Traverse(local, [&](const Triple& pos, const double dist)
         {
-          for(double boxY = (std::floor(yCond.first/fWidth)+0.5)*fWidth; boxY < (std::floor(yCond.second/fWidth)+1.0)*fWidth; boxY += fWidth)
+          auto& hit = hitMap[pos];
+          ++hit.NContrib;
+          hit.Time += local.T0 + (local.T1 - local.T0)*dist/length; 
+                                                                  //TODO: The particle is slowing down if it is depositing energy.  So, this time is also wrong, but 
+                                                                  //      slightly more realistic than using starting time.  I could get the velocity at a point and 
+                                                                  //      use that to get time here.    
+              
+          const double edep = (fUseSecondary?segEnergy:segSecondary)*dist/length;
+          hit.Energy += edep; 
+          if(pred(seg)) hit.OtherE += edep; //User hook to keep track of energy from "special" segments
+          else 
           {
-            for(double boxZ = (std::floor(zCond.first/fWidth)+0.5)*fWidth; boxZ < (std::floor(zCond.second/fWidth)+1.0)*fWidth; boxZ += fWidth)
-            {
-              TVector3 boxCenter(boxX, boxY, boxZ);
-                   
-              Triple pos(std::lrint(boxX/fWidth-0.5), std::lrint(boxY/fWidth-0.5), std::lrint(boxZ/fWidth-0.5)); 
-              //std::lrint rounds to the nearest integer and casts (hopefully correctly) to that integer.
-              auto& hit = hitMap[pos];
-              const double dist = LengthInsideBox(seg, boxCenter, mat);
-    
-              if(dist > 0)
-              {
-                ++hit.NContrib;
-                const double length = (segStop.Vect()-segStart.Vect()).Mag();
-                hit.Time += segStart.T() + (segStop.T() - segStart.T())*dist/length; 
-                                                                        //TODO: The particle is slowing down if it is depositing energy.  So, this time is also wrong, but 
-                                                                        //      slightly more realistic than using starting time.  I could get the velocity at a point and 
-                                                                        //      use that to get time here.    
-                    
-                if(dist <= length+1e-5) //TODO: remove sanity check on distance
-                {
-                  const double edep = (fUseSecondary?segEnergy:segSecondary)*dist/length;
-                  hit.Energy += edep; 
-                  if(pred(seg)) hit.OtherE += edep; //User hook to keep track of energy from "special" segments
-                  else 
-                  {
-                    hit.TrackIDs.push_back(segPrim);
-                  }
-                }
-                else std::cerr << "Got distance inside hitBox that is greater than this segment's length!  dist is: " << dist << "\nlength is: " << length << "\n";
-              }
-            } //Loop over x positions on this segment
-          } //Loop over y positions on this segment
-        } //Loop over z positions on this segment
+            hit.TrackIDs.push_back(segPrim);
+          }
+        });
       }
 
 
       //Turn the elements of the map from MakeHitData back into an MCHit.
-      pers::MCHit MakeHit(const std::pair<Triple, HitData>& hitData, TGeoMatrix* mat); //Not const because using PRNG
+      pers::MCHit MakeHit(const std::pair<Triple, HitData>& hitData, const TGeoMatrix* mat); //Not const because using PRNG
 
     protected:
       //Data members
       double fWidth; //The width of the cubes used to make HitData objects and MCHits
-      TGeoBBox fHitBox; //The geometry of one MCHit
       bool fUseSecondary; //Use TG4HitSegment::SecondaryDeposit instead of EnergyDeposit?  There exists a 
                           //prototype for a mechanism to put the Birks' Law-corrected visible energy in the secondary deposit. 
 
       //Internal methods
-      double LengthInsideBox(const TG4HitSegment& seg, const TVector3& boxCenter, TGeoMatrix* mat) const;
+      //Call visit(Triple, double) with each cube that seg passes through and the length of seg inside the cube.  This is a 3D digital differential analyzer (Amanatides 
+      //and Woo, 1987): it steps from one cube boundary to the next, so it only ever visits cubes that the line crosses.  Cubes 
+      //that the line only touches get no call at all because the line has no length inside them.
+      template <class VISIT>
+      void Traverse(const LocalSegment& seg, VISIT&& visit) const
+      {
+        const double length = seg.Length;
+        if(!(length > 0.)) return; //Nothing to share
+
+        const double* begin = seg.Start;
+        const double* end = seg.Stop;
+        const double inf = std::numeric_limits<double>::infinity();
+        int index[3], last[3], step[3];
+        double tMax[3], tDelta[3]; //Fraction of the line at which it next crosses a boundary on each axis and between boundaries on each axis
+        size_t nSteps = 1; //Number of cubes to visit if the line never crosses an edge or corner exactly
+        for(int axis = 0; axis < 3; ++axis)
+        {
+          const double dir = end[axis] - begin[axis]; //Not normalized so that tMax reaches 1 exactly at seg.Stop
+          index[axis] = std::floor(begin[axis]/fWidth);
+          last[axis] = std::floor(end[axis]/fWidth);
+          nSteps += std::abs(last[axis] - index[axis]);
+          if(dir > 0.)
+          {
+            step[axis] = 1;
+            tMax[axis] = ((index[axis]+1)*fWidth - begin[axis])/dir;
+            tDelta[axis] = fWidth/dir;
+          }
+          else if(dir < 0.)
+          {
+            step[axis] = -1;
+            tMax[axis] = (index[axis]*fWidth - begin[axis])/dir;
+            tDelta[axis] = -fWidth/dir;
+          }
+          else
+          {
+            step[axis] = 0;
+            tMax[axis] = inf;
+            tDelta[axis] = inf;
+          }
+        }
+
+        double t = 0.;
+        for(size_t visited = 0; visited < nSteps; ++visited)
+        {
+          //Leave this cube through whichever boundary comes first
+          int axis = 0;
+          if(tMax[1] < tMax[axis]) axis = 1;
+          if(tMax[2] < tMax[axis]) axis = 2;
+          const double tExit = std::min(tMax[axis], 1.);
+
+          if(tExit > t) visit(Triple(index[0], index[1], index[2]), (tExit - t)*length);
+          if(tExit >= 1.) return; //Stopped inside this cube
+
+          t = tExit;
+          index[axis] += step[axis];
+          tMax[axis] += tDelta[axis];
+        }
+      }
 
       //PRNG for smearing times
       std::mt19937 fGen; //Mersenne Twister engine with period of 19937
@@ -0,0 +1,219 @@
+//File: HitClusterer.h
+//Brief: A HitClusterer groups MCHits into MCClusters.  2 MCHits are neighbors if their centers are closer than reach
+//       times their average width along every axis, and an MCCluster is every MCHit that is connected by a chain of
+//       neighbors.  Group() just finds which MCHits are in the same cluster for Reconstructors that want to fill their
+//       own MCClusters.
+//
+//       MCHits are bucketed into a VoxelMap of cells as wide as the farthest any 2 MCHits in the event could be from
+//       each other and still be neighbors.  So, each MCHit only has to be compared to MCHits in the 27 cells around
+//       it instead of to every other MCHit.  Neighbors are joined with DisjointSets.  Then, every MCCluster's
+//       properties are accumulated in one pass over the MCHits' indices without copying any MCHits.
+//
+//       HITS can be any container of pers::MCHits with operator[] and size(), like a std::vector or a plgn::Handle.
+//       Keeps all memory around between events.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//local includes
+#include "reco/alg/GridHits.h"
+#include "reco/alg/VoxelMap.h"
+#include "reco/alg/DisjointSets.h"
+
+//persistency includes
+#include "persistency/MCHit.h"
+#include "persistency/MCCluster.h"
+
+//ROOT includes
+#include "TLorentzVector.h"
+
+//c++ includes
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#ifndef RECO_HITCLUSTERER_H
+#define RECO_HITCLUSTERER_H
+
+namespace reco
+{
+  class HitClusterer
+  {
+    public:
+      HitClusterer(const double reach): fReach(reach), fCells(), fNext(), fGroups(), fLast(), fClusterOf(), fSums() {}
+      virtual ~HitClusterer() = default;
+
+      //Find which cluster each MCHit in hits belongs to without making any MCClusters.  Returns the number of clusters.
+      //ClusterOf() is the index of each MCHit's cluster afterward.  Clusters are in order of the last MCHit that joined
+      //each one.
+      template <class HITS>
+      size_t Group(const HITS& hits)
+      {
+        const size_t nHits = hits.size();
+        fGroups.Reset(nHits);
+        fClusterOf.clear();
+        if(nHits == 0) return 0;
+
+        //Bucket MCHits into cells as wide as the biggest distance that 2 MCHits in this event can be apart and still be
+        //neighbors.  Each cell is a linked list through fNext.
+        double maxWidth = 0.;
+        for(size_t hit = 0; hit < nHits; ++hit) maxWidth = std::max(maxWidth, hits[hit].Width);
+        double cellSize = maxWidth*fReach;
+        if(!(cellSize > 0.)) cellSize = 1.; //MCHits with no Width are never neighbors anyway
+
+        fCells.clear();
+        fNext.assign(nHits, kNone);
+        for(size_t hit = 0; hit < nHits; ++hit)
+        {
+          auto& head = fCells[CellOf(hits[hit].Position, cellSize)];
+          fNext[hit] = head.First;
+          head.First = hit;
+        }
+
+        //Join each MCHit with its neighbors
+        for(size_t hit = 0; hit < nHits; ++hit)
+        {
+          const auto& pos = hits[hit].Position;
+          const auto cell = CellOf(pos, cellSize);
+          for(int xOff = -1; xOff < 2; ++xOff)
+          {
+            for(int yOff = -1; yOff < 2; ++yOff)
+            {
+              for(int zOff = -1; zOff < 2; ++zOff)
+              {
+                const auto found = fCells.find(GridHits::Triple(cell.First+xOff, cell.Second+yOff, cell.Third+zOff));
+                if(!found) continue;
+
+                for(size_t other = found->second.First; other != kNone; other = fNext[other])
+                {
+                  if(other < hit && AreNeighbors(hits[hit], hits[other])) fGroups.Union(hit, other);
+                }
+              }
+            }
+          }
+        }
+
+        //Number clusters in order of the last MCHit that joined each one
+        fLast.assign(nHits, 0);
+        for(size_t hit = 0; hit < nHits; ++hit) fLast[fGroups.Find(hit)] = hit;
+
+        fClusterOf.assign(nHits, kNone);
+        size_t nClusters = 0;
+        for(size_t hit = 0; hit < nHits; ++hit)
+        {
+          const size_t root = fGroups.Find(hit);
+          if(fLast[root] == hit) fClusterOf[root] = nClusters++;
+        }
+        for(size_t hit = 0; hit < nHits; ++hit) fClusterOf[hit] = fClusterOf[fGroups.Find(hit)];
+
+        return nClusters;
+      }
+
+      //Put an MCCluster in clusters for each group of neighboring MCHits in hits.  clusters is cleared first.
+      //FirstPosition is the position of the MCHit closest to vertex.  MCClusters are in the same order as Group().
+      template <class HITS>
+      void Cluster(const HITS& hits, const TLorentzVector& vertex, std::vector<pers::MCCluster>& clusters)
+      {
+        clusters.clear();
+        const size_t nHits = hits.size();
+        fSums.assign(Group(hits), Sums());
+
+        //Accumulate each cluster's properties in one pass
+        clusters.resize(fSums.size());
+        for(auto& clust: clusters) clust.Energy = 0.; //MCCluster's constructor doesn't set Energy
+        for(size_t hit = 0; hit < nHits; ++hit)
+        {
+          const size_t cluster = fClusterOf[hit];
+          const auto& mcHit = hits[hit];
+          auto& sum = fSums[cluster];
+          auto& clust = clusters[cluster];
+
+          clust.Energy += mcHit.Energy;
+          clust.TrackIDs.insert(clust.TrackIDs.end(), mcHit.TrackIDs.begin(), mcHit.TrackIDs.end());
+          sum.Position += mcHit.Position*mcHit.Energy;
+
+          const double dist = (mcHit.Position-vertex).Vect().Mag();
+          if(sum.First == kNone || dist < sum.FirstDist)
+          {
+            sum.First = hit;
+            sum.FirstDist = dist;
+          }
+
+          for(int axis = 0; axis < 3; ++axis)
+          {
+            if(sum.Min[axis] == kNone || mcHit.Position[axis] < hits[sum.Min[axis]].Position[axis]) sum.Min[axis] = hit;
+            if(sum.Max[axis] == kNone || mcHit.Position[axis] > hits[sum.Max[axis]].Position[axis]) sum.Max[axis] = hit;
+          }
+        }
+
+        for(size_t cluster = 0; cluster < clusters.size(); ++cluster)
+        {
+          const auto& sum = fSums[cluster];
+          auto& clust = clusters[cluster];
+
+          clust.Position = sum.Position*(1./clust.Energy); //Energy-weighted centroid
+          clust.FirstPosition = hits[sum.First].Position;
+
+          //The MCHit farthest from the centroid along an axis is either the one with the smallest or the largest coordinate
+          clust.XWidth = Width(hits[sum.Min[0]], hits[sum.Max[0]], clust.Position.X(), 0);
+          clust.YWidth = Width(hits[sum.Min[1]], hits[sum.Max[1]], clust.Position.Y(), 1);
+          clust.ZWidth = Width(hits[sum.Min[2]], hits[sum.Max[2]], clust.Position.Z(), 2);
+        }
+      }
+
+      //Index into the last Cluster() call's clusters of each MCHit
+      const std::vector<size_t>& ClusterOf() const { return fClusterOf; }
+
+    private:
+      enum : size_t { kNone = std::numeric_limits<size_t>::max() }; //No MCHit.  An enum so it never needs a definition outside the class.
+
+      //Head of the linked list of MCHits in a cell.  Default-constructs to an empty list for VoxelMap::operator[].
+      struct Cell
+      {
+        Cell(): First(kNone) {}
+        size_t First;
+      };
+
+      //Everything about a cluster that isn't already in its MCCluster
+      struct Sums
+      {
+        Sums(): Position(0., 0., 0., 0.), First(kNone), FirstDist(0.), Min{kNone, kNone, kNone}, Max{kNone, kNone, kNone} {}
+
+        TLorentzVector Position; //Energy-weighted sum of positions
+        size_t First; //MCHit closest to the vertex
+        double FirstDist; //Distance from First to the vertex
+        size_t Min[3]; //MCHit with the smallest coordinate along each axis
+        size_t Max[3]; //MCHit with the largest coordinate along each axis
+      };
+
+      double fReach; //MCHits closer than this many average widths along every axis are neighbors
+
+      VoxelMap<GridHits::Triple, Cell> fCells; //MCHits in each cell
+      std::vector<size_t> fNext; //Next MCHit in the same cell as each MCHit
+      DisjointSets fGroups; //MCHits that are connected by chains of neighbors
+      std::vector<size_t> fLast; //Last MCHit in each group.  Only valid for representatives.
+      std::vector<size_t> fClusterOf; //Cluster index of each MCHit
+      std::vector<Sums> fSums; //Accumulated properties of each cluster
+
+      GridHits::Triple CellOf(const TLorentzVector& pos, const double cellSize) const
+      {
+        return GridHits::Triple(std::floor(pos.X()/cellSize), std::floor(pos.Y()/cellSize), std::floor(pos.Z()/cellSize));
+      }
+
+      bool AreNeighbors(const pers::MCHit& first, const pers::MCHit& second) const
+      {
+        const auto diff = first.Position-second.Position;
+        const double width = (first.Width+second.Width)/2.*fReach;
+        return (std::fabs(diff.X()) < width && std::fabs(diff.Y()) < width && std::fabs(diff.Z()) < width);
+      }
+
+      //Full width of a cluster along axis given the MCHits with the smallest and largest coordinates along that axis
+      static float Width(const pers::MCHit& min, const pers::MCHit& max, const double center, const int axis)
+      {
+        const double below = std::fabs(min.Position[axis] - center), above = std::fabs(max.Position[axis] - center);
+        if(below >= above) return 2.*below + min.Width;
+        return 2.*above + max.Width;
+      }
+  };
+}
+
+#endif //RECO_HITCLUSTERER_H
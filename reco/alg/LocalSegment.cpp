@@ -0,0 +1,50 @@
+//File: LocalSegment.cpp
+//Brief: A TG4HitSegment in the coordinate system of a detector volume.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//Include header
+#include "reco/alg/LocalSegment.h"
+
+//edepsim includes
+#include "TG4HitSegment.h"
+
+//ROOT includes
+#include "TGeoMatrix.h"
+
+//c++ includes
+#include <cmath>
+#include <algorithm>
+
+namespace reco
+{
+  LocalSegment::LocalSegment(const TG4HitSegment& seg, const TGeoMatrix* mat)
+  {
+    #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
+    const auto& segStart = seg.GetStart();
+    const auto& segStop = seg.GetStop();
+    #else
+    const auto& segStart = seg.Start;
+    const auto& segStop = seg.Stop;
+    #endif
+
+    const double start[] = {segStart.X(), segStart.Y(), segStart.Z()}, stop[] = {segStop.X(), segStop.Y(), segStop.Z()};
+    mat->MasterToLocal(start, Start);
+    mat->MasterToLocal(stop, Stop);
+    T0 = segStart.T();
+    T1 = segStop.T();
+
+    SetLength();
+  }
+
+  LocalSegment::LocalSegment(const double start[3], const double stop[3], const double t0, const double t1): T0(t0), T1(t1)
+  {
+    std::copy(start, start+3, Start);
+    std::copy(stop, stop+3, Stop);
+    SetLength();
+  }
+
+  void LocalSegment::SetLength()
+  {
+    Length = std::sqrt((Stop[0]-Start[0])*(Stop[0]-Start[0]) + (Stop[1]-Start[1])*(Stop[1]-Start[1]) + (Stop[2]-Start[2])*(Stop[2]-Start[2]));
+  }
+}
@@ -0,0 +1,34 @@
+//File: LocalSegment.h
+//Brief: A LocalSegment is a TG4HitSegment converted to the coordinate system of a detector volume once.  GridHits used to 
+//       call geo::InLocal() on both ends of a segment for every cube it might deposit energy in.  Now, everything that 
+//       looks at where a segment is inside a detector shares one LocalSegment instead.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+#ifndef RECO_LOCALSEGMENT_H
+#define RECO_LOCALSEGMENT_H
+
+class TG4HitSegment;
+class TGeoMatrix;
+
+namespace reco
+{
+  struct LocalSegment
+  {
+    //Convert seg to the coordinate system described by mat
+    LocalSegment(const TG4HitSegment& seg, const TGeoMatrix* mat);
+
+    //From positions that are already in a detector's coordinate system
+    LocalSegment(const double start[3], const double stop[3], const double t0, const double t1);
+
+    double Start[3]; //Position where this segment starts in the detector's coordinate system
+    double Stop[3]; //Position where this segment stops in the detector's coordinate system
+    double Length; //Distance from Start to Stop
+    double T0; //Time when this segment starts
+    double T1; //Time when this segment stops
+
+    private:
+      void SetLength(); //Calculate Length from Start and Stop
+  };
+}
+
+#endif //RECO_LOCALSEGMENT_H
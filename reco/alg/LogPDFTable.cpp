@@ -0,0 +1,53 @@
+//File: LogPDFTable.cpp
+//Brief: A LogPDFTable is a copy of a 2D PDF histogram as one flat table of log10(bin content).  See LogPDFTable.h.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//Include header
+#include "reco/alg/LogPDFTable.h"
+
+//ROOT includes
+#include "TH2.h"
+#include "TAxis.h"
+
+namespace reco
+{
+  LogPDFTable::Axis::Axis(const TAxis& axis): fNBins(axis.GetNbins()), fMin(axis.GetXmin()), fMax(axis.GetXmax()),
+                                              fUniform(!axis.IsVariableBinSize()), fWidth(fMax - fMin),
+                                              fEdges(), fCenters()
+  {
+    for(size_t bin = 1; bin <= fNBins; ++bin) fEdges.push_back(axis.GetBinLowEdge(bin));
+    fEdges.push_back(axis.GetBinUpEdge(fNBins));
+    for(size_t bin = 0; bin <= fNBins+1; ++bin) fCenters.push_back(axis.GetBinCenter(bin));
+  }
+
+  LogPDFTable::LogPDFTable(const TH2& pdf, const bool interpolate): fX(*pdf.GetXaxis()), fY(*pdf.GetYaxis()), fInterpolate(interpolate),
+                                                                    fContent(), fLog10()
+  {
+    fContent.resize((fX.NBins()+2)*(fY.NBins()+2));
+    for(size_t yBin = 0; yBin <= fY.NBins()+1; ++yBin)
+    {
+      for(size_t xBin = 0; xBin <= fX.NBins()+1; ++xBin) fContent[Index(xBin, yBin)] = pdf.GetBinContent(xBin, yBin);
+    }
+
+    fLog10.resize(fContent.size());
+    std::transform(fContent.begin(), fContent.end(), fLog10.begin(), [](const double content) { return std::log10(content); });
+  }
+
+  double LogPDFTable::Interpolate(const double x, const double y) const
+  {
+    const size_t xBin = fX.Bin(x), yBin = fY.Bin(y);
+    if(xBin == 0 || xBin > fX.NBins() || yBin == 0 || yBin > fY.NBins()) return fContent[Index(xBin, yBin)];
+
+    //Which 2 bin centers along each axis is this point between?  Clamp to the first and last bins.
+    const size_t xLow = std::min(std::max((x < fX.Center(xBin))?xBin-1:xBin, size_t(1)), std::max(fX.NBins(), size_t(2))-1),
+                 yLow = std::min(std::max((y < fY.Center(yBin))?yBin-1:yBin, size_t(1)), std::max(fY.NBins(), size_t(2))-1);
+    double xFrac = 0., yFrac = 0.;
+
+    if(fX.NBins() > 1) xFrac = std::min(std::max((x - fX.Center(xLow))/(fX.Center(xLow+1) - fX.Center(xLow)), 0.), 1.);
+    if(fY.NBins() > 1) yFrac = std::min(std::max((y - fY.Center(yLow))/(fY.Center(yLow+1) - fY.Center(yLow)), 0.), 1.);
+    const size_t xHigh = std::min(xLow+1, fX.NBins()), yHigh = std::min(yLow+1, fY.NBins());
+
+    return (1.-xFrac)*(1.-yFrac)*fContent[Index(xLow, yLow)] + xFrac*(1.-yFrac)*fContent[Index(xHigh, yLow)]
+         + (1.-xFrac)*yFrac*fContent[Index(xLow, yHigh)] + xFrac*yFrac*fContent[Index(xHigh, yHigh)];
+  }
+}
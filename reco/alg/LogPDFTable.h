@@ -0,0 +1,85 @@
+//File: LogPDFTable.h
+//Brief: A LogPDFTable is a copy of a 2D PDF histogram as one flat table of log10(bin content).  Likelihood-based
+//       Reconstructors like CandFromPDF look up a log-likelihood for every cluster in every event.  Asking a TH2D
+//       means FindBin() and GetBinContent() through virtual functions and a std::log10() each time.  A LogPDFTable
+//       does all of the logarithms once when it is made.  Finding a bin on a uniform axis is a little arithmetic, and
+//       axes with variable bin sizes use a binary search over their edges.
+//
+//       Can also interpolate bilinearly between bin centers like TH2::Interpolate().  Interpolation is done on bin
+//       contents before taking the logarithm so that empty bins don't make everything around them -infinity.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//c++ includes
+#include <vector>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+
+#ifndef RECO_LOGPDFTABLE_H
+#define RECO_LOGPDFTABLE_H
+
+class TH2;
+class TAxis;
+
+namespace reco
+{
+  class LogPDFTable
+  {
+    public:
+      //Copy pdf's bin contents including under- and overflow bins.  pdf is never used again after this.
+      LogPDFTable(const TH2& pdf, const bool interpolate);
+      virtual ~LogPDFTable() = default;
+
+      //log10 of the PDF at (x, y).  Without interpolation, this is the same as
+      //std::log10(pdf.GetBinContent(pdf.FindBin(x, y))).
+      double operator ()(const double x, const double y) const
+      {
+        if(!fInterpolate) return fLog10[Index(fX.Bin(x), fY.Bin(y))];
+        return std::log10(Interpolate(x, y));
+      }
+
+    private:
+      //Everything needed to find a bin on one axis.  Bins are numbered like ROOT's: 0 is underflow, and NBins+1 is overflow.
+      class Axis
+      {
+        public:
+          Axis(const TAxis& axis);
+
+          //Same answer as TAxis::FindFixBin().  Uniform axes use the same arithmetic so that round-off at bin edges goes 
+          //the same way.
+          size_t Bin(const double x) const
+          {
+            if(x < fMin) return 0;
+            if(!(x < fMax)) return fNBins+1;
+            if(fUniform) return size_t(fNBins*(x - fMin)/fWidth) + 1;
+            return std::upper_bound(fEdges.begin(), fEdges.end(), x) - fEdges.begin();
+          }
+
+          size_t NBins() const { return fNBins; }
+          double Center(const size_t bin) const { return fCenters[bin]; }
+
+        private:
+          size_t fNBins; //Number of bins not including under- and overflow
+          double fMin; //Low edge of the first bin
+          double fMax; //High edge of the last bin
+          bool fUniform; //Are all bins the same width?
+          double fWidth; //fMax - fMin
+          std::vector<double> fEdges; //Low edge of each bin from 1 to NBins plus the high edge of the last bin
+          std::vector<double> fCenters; //Center of each bin from 0 to NBins+1.  Flow bins' centers are never used.
+      };
+
+      Axis fX; //Binning along the x axis
+      Axis fY; //Binning along the y axis
+      bool fInterpolate; //Interpolate between bin centers?
+      std::vector<double> fContent; //Bin contents in the same order as TH2::GetBin()
+      std::vector<double> fLog10; //log10 of each element of fContent
+
+      size_t Index(const size_t xBin, const size_t yBin) const { return xBin + (fX.NBins()+2)*yBin; }
+
+      //Bilinear interpolation between the centers of the 4 bins around (x, y).  Uses the closest bin's content outside
+      //the histogram's range, and stays constant beyond the centers of the first and last bins like ROOT does.
+      double Interpolate(const double x, const double y) const;
+  };
+}
+
+#endif //RECO_LOGPDFTABLE_H
@@ -0,0 +1,111 @@
+//File: NeighborCut.h
+//Brief: A NeighborCut decides which candidate neutron hits are isolated from everything else.  A candidate fails if there is
+//       a visible non-neutron hit within nCubes of it.  Then, a candidate also fails if any candidate connected to it by a
+//       chain of candidates within nCubes of each other failed.  That weeds out hits from neutron-induced tracks that start
+//       too close to non-neutron hits.  GridNeutronHits used to get that second rule by moving candidates between 2
+//       std::maps until nothing changed.  A NeighborCut groups candidates with DisjointSets while it does the first cut
+//       instead, then decides whether each group failed in one pass.
+//
+//       Voxels near each candidate are found with VoxelSums, so the time to look around a candidate doesn't grow like
+//       nCubes^3.  KEY must work with VoxelSums, VoxelMap, and std::sort() like GridHits::Triple.  Keeps all memory around
+//       between events.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//local includes
+#include "reco/alg/VoxelMap.h"
+#include "reco/alg/VoxelSums.h"
+#include "reco/alg/DisjointSets.h"
+
+//c++ includes
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+#ifndef RECO_NEIGHBORCUT_H
+#define RECO_NEIGHBORCUT_H
+
+namespace reco
+{
+  template <class KEY>
+  class NeighborCut
+  {
+    public:
+      NeighborCut(): fNeutronSums(), fOtherSums(), fCandidates(), fCandIndex(), fGroups(), fFailed(), fNeighbors(), fPassed() {}
+      virtual ~NeighborCut() = default;
+
+      //Start a new event
+      void clear()
+      {
+        fNeutronSums.clear();
+        fOtherSums.clear();
+        fCandidates.clear();
+        fCandIndex.clear();
+      }
+
+      //Add a voxel that might be a neutron hit.  Don't add the same voxel twice.
+      void AddCandidate(const KEY& voxel)
+      {
+        fNeutronSums.insert(voxel);
+        fCandIndex[voxel] = fCandidates.size();
+        fCandidates.push_back(voxel);
+      }
+
+      //Add a visible voxel that isn't a neutron hit.  Candidates near it fail.
+      void AddOther(const KEY& voxel) { fOtherSums.insert(voxel); }
+
+      //Every candidate that passes with neighbors up to nCubes away on each axis, sorted like std::map<KEY, ...>.  Call
+      //after the last AddCandidate() and AddOther() for this event.
+      const std::vector<KEY>& Passed(const size_t nCubes)
+      {
+        fNeutronSums.Build();
+        fOtherSums.Build();
+
+        fGroups.Reset(fCandidates.size());
+        fFailed.assign(fCandidates.size(), false);
+        for(size_t cand = 0; cand < fCandidates.size(); ++cand)
+        {
+          if(!Neighbors(fCandidates[cand], nCubes)) fFailed[cand] = true;
+          for(const auto& neighbor: fNeighbors) fGroups.Union(cand, fCandIndex.find(neighbor)->second);
+        }
+
+        for(size_t cand = 0; cand < fCandidates.size(); ++cand)
+        {
+          if(fFailed[cand]) fFailed[fGroups.Find(cand)] = true;
+        }
+
+        fPassed.clear();
+        for(size_t cand = 0; cand < fCandidates.size(); ++cand)
+        {
+          if(!fFailed[fGroups.Find(cand)]) fPassed.push_back(fCandidates[cand]);
+        }
+        std::sort(fPassed.begin(), fPassed.end());
+
+        return fPassed;
+      }
+
+    private:
+      VoxelSums<KEY> fNeutronSums; //Every candidate
+      VoxelSums<KEY> fOtherSums; //Every visible voxel that isn't a candidate
+      std::vector<KEY> fCandidates; //Position of each candidate
+      VoxelMap<KEY, size_t> fCandIndex; //Index into fCandidates of each candidate's position
+      DisjointSets fGroups; //Candidates that are connected by chains of neighbors
+      std::vector<bool> fFailed; //Did each candidate fail?  After grouping, whether each group failed.
+      std::vector<KEY> fNeighbors; //Candidates near the candidate being considered
+      std::vector<KEY> fPassed; //Candidates whose whole group passed
+
+      //Return whether there is no visible non-neutron voxel within nCubes of cand, and fill fNeighbors with every candidate
+      //within nCubes of cand, including cand itself.
+      bool Neighbors(const KEY& cand, const size_t nCubes)
+      {
+        const int dist = nCubes;
+        const KEY low(cand.First - dist, cand.Second - dist, cand.Third - dist),
+                  high(cand.First + dist, cand.Second + dist, cand.Third + dist);
+
+        fNeighbors.clear();
+        fNeutronSums.ForEach(low, high, [this](const KEY& pos) { fNeighbors.push_back(pos); });
+        return fOtherSums.Count(low, high) == 0;
+      }
+  };
+}
+
+#endif //RECO_NEIGHBORCUT_H
@@ -0,0 +1,353 @@
+//File: Octree.h
+//Brief: Algorithm to break up objects with 3-vectors into octants.  Each level of an Octree splits a box into 8
+//       octants, and leaves at Depth() levels below the root hold a CELL.  Finding an object's CELL takes Depth()
+//       decisions, so search is linear in number of queries and constant in number of objects already sorted.
+//
+//       Only the nodes that something has been put into exist.  They live in one std::vector that clear() and
+//       Reset() keep around, so an Octree that is a member of a plugin stops allocating memory after the first
+//       few events.  Depth is chosen at runtime.  Box() and Sphere() visit every CELL whose center is in a range for 
+//       clustering.
+//
+//       Segment() puts a line segment like a TG4HitSegment into every leaf it passes through.  It clips the segment
+//       against each node's box on the way down instead of stepping through a uniform grid, so it only does work in
+//       the parts of the tree that the segment actually crosses.
+//
+//       KEY is a 3-vector like TVector3 with operator[] and a constructor that takes x, y, and z.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//ROOT includes
+#include "TVector3.h"
+
+//c++ includes
+#include <vector>
+#include <array>
+#include <utility>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+
+#ifndef RECO_OCTREE_H
+#define RECO_OCTREE_H
+
+namespace reco
+{
+  template <class CELL, class KEY=TVector3>
+  class Octree
+  {
+    public:
+      //center is the center of the box this Octree covers, and halfWidth is half of its width along each axis.
+      Octree(const KEY& center, const KEY& halfWidth, const size_t depth): fCenter{{center[0], center[1], center[2]}},
+                                                                           fHalfWidth{{halfWidth[0], halfWidth[1], halfWidth[2]}},
+                                                                           fDepth(depth), fNodes(), fCells(), fNCells(0)
+      {
+        clear();
+      }
+
+      virtual ~Octree() = default;
+
+      //Forget every CELL but keep the memory for the next event
+      void clear()
+      {
+        fNodes.resize(1);
+        fNodes[0] = Node();
+        fNCells = 0;
+      }
+
+      //Forget every CELL and cover a new box with depth levels
+      void Reset(const KEY& center, const KEY& halfWidth, const size_t depth)
+      {
+        for(size_t axis = 0; axis < 3; ++axis)
+        {
+          fCenter[axis] = center[axis];
+          fHalfWidth[axis] = halfWidth[axis];
+        }
+        fDepth = depth;
+        clear();
+      }
+
+      //Make this look somewhat like a std::map even though it isn't.  Returns the center of the leaf that pos is in and
+      //that leaf's CELL.  Default-constructs a CELL if there wasn't one there yet.  Positions outside the box go in the
+      //nearest leaf.  The CELL* is an observer pointer that is only valid until something else is put into this Octree.
+      std::pair<KEY, CELL*> operator [](const KEY& pos)
+      {
+        Coords center = fCenter, halfWidth = fHalfWidth;
+        size_t node = 0;
+        for(size_t level = 0; level < fDepth; ++level)
+        {
+          const size_t octant = Descend(pos, center, halfWidth);
+          if(fNodes[node].Children[octant] == kNone)
+          {
+            fNodes[node].Children[octant] = fNodes.size();
+            fNodes.emplace_back();
+          }
+          node = fNodes[node].Children[octant];
+        }
+
+        if(fNodes[node].Cell == kNone) fNodes[node].Cell = NewCell(center);
+        auto& cell = fCells[fNodes[node].Cell];
+        return std::make_pair(cell.first, &cell.second);
+      }
+
+      //CELL of the leaf that pos is in, or nullptr if nothing has been put there.  Never adds anything.
+      const CELL* find(const KEY& pos) const
+      {
+        Coords center = fCenter, halfWidth = fHalfWidth;
+        size_t node = 0;
+        for(size_t level = 0; level < fDepth; ++level)
+        {
+          node = fNodes[node].Children[Descend(pos, center, halfWidth)];
+          if(node == kNone) return nullptr;
+        }
+
+        if(fNodes[node].Cell == kNone) return nullptr;
+        return &fCells[fNodes[node].Cell].second;
+      }
+
+      //This is how you should loop over the elements of an Octree (unfortunately).
+      //VISITOR is any callable object that takes a CELL*, so it can be stateful.
+      //You could also use a lambda function that just captures the variable for
+      //the result you want to calculate.  Only CELLs that exist are visited, in the order they were made.
+      template <class VISITOR>
+      void visitor(VISITOR&& visit)
+      {
+        for(size_t cell = 0; cell < fNCells; ++cell) visit(&fCells[cell].second);
+      }
+
+      //Call visit(const KEY& center, CELL& cell) for every CELL whose center is inside the box from low to high.
+      //Skips whole branches of the tree that don't overlap that box.
+      template <class VISITOR>
+      void Box(const KEY& low, const KEY& high, VISITOR&& visit)
+      {
+        const Coords boxLow{{low[0], low[1], low[2]}}, boxHigh{{high[0], high[1], high[2]}};
+        Range(0, 0, fCenter, fHalfWidth,
+              [&boxLow, &boxHigh](const Coords& center, const Coords& halfWidth)
+              {
+                for(size_t axis = 0; axis < 3; ++axis)
+                {
+                  if(center[axis] + halfWidth[axis] < boxLow[axis] || center[axis] - halfWidth[axis] > boxHigh[axis]) return false;
+                }
+                return true;
+              },
+              [&boxLow, &boxHigh](const Coords& center)
+              {
+                for(size_t axis = 0; axis < 3; ++axis)
+                {
+                  if(center[axis] < boxLow[axis] || center[axis] > boxHigh[axis]) return false;
+                }
+                return true;
+              }, visit);
+      }
+
+      //Call visit(const KEY& center, CELL& cell) for every CELL whose center is within radius of sphereCenter.
+      //Skips whole branches of the tree that don't overlap that sphere.
+      template <class VISITOR>
+      void Sphere(const KEY& sphereCenter, const double radius, VISITOR&& visit)
+      {
+        const Coords sphere{{sphereCenter[0], sphereCenter[1], sphereCenter[2]}};
+        const double radius2 = radius*radius;
+        Range(0, 0, fCenter, fHalfWidth,
+              [&sphere, radius2](const Coords& center, const Coords& halfWidth)
+              {
+                double dist2 = 0.; //Squared distance from sphere's center to the closest point in this node's box
+                for(size_t axis = 0; axis < 3; ++axis)
+                {
+                  const double outside = std::fabs(sphere[axis] - center[axis]) - halfWidth[axis];
+                  if(outside > 0.) dist2 += outside*outside;
+                }
+                return dist2 <= radius2;
+              },
+              [&sphere, radius2](const Coords& center)
+              {
+                double dist2 = 0.;
+                for(size_t axis = 0; axis < 3; ++axis) dist2 += (center[axis] - sphere[axis])*(center[axis] - sphere[axis]);
+                return dist2 <= radius2;
+              }, visit);
+      }
+
+      //Call visit(const KEY& center, CELL& cell, double enter, double exit) for every leaf that the segment from
+      //start to stop passes through.  enter and exit are the fractions of the way from start to stop where the
+      //segment goes into and comes out of that leaf, so exit - enter is the fraction of its length in the leaf.
+      //Leaves are made as needed like operator[].  Parts of the segment outside the whole box are not visited, and a
+      //segment with no length is entirely in the leaf that start is in.  Leaves are visited in octant order, not in
+      //order along the segment.
+      template <class VISITOR>
+      void Segment(const KEY& start, const KEY& stop, VISITOR&& visit)
+      {
+        const Coords origin{{start[0], start[1], start[2]}}, dir{{stop[0] - start[0], stop[1] - start[1], stop[2] - start[2]}};
+        if(dir[0] == 0. && dir[1] == 0. && dir[2] == 0.)
+        {
+          auto found = (*this)[start];
+          visit(const_cast<const KEY&>(found.first), *found.second, 0., 1.);
+          return;
+        }
+
+        //Clip [0, 1] to the whole box one axis at a time
+        double enter = 0., exit = 1.;
+        for(size_t axis = 0; axis < 3; ++axis)
+        {
+          const double low = fCenter[axis] - fHalfWidth[axis], high = fCenter[axis] + fHalfWidth[axis];
+          if(dir[axis] == 0.)
+          {
+            if(origin[axis] < low || origin[axis] > high) return;
+            continue;
+          }
+
+          double first = (low - origin[axis])/dir[axis], second = (high - origin[axis])/dir[axis];
+          if(first > second) std::swap(first, second);
+          enter = std::max(enter, first);
+          exit = std::min(exit, second);
+        }
+        if(!(exit > enter)) return;
+
+        Clip(0, 0, fCenter, fHalfWidth, origin, dir, enter, exit, visit);
+      }
+
+      //Number of levels below the root.  Leaves are 2^Depth() times narrower than the whole box.
+      size_t Depth() const { return fDepth; }
+
+      //Full width of each leaf along axis
+      double LeafWidth(const size_t axis) const { return std::ldexp(2.*fHalfWidth[axis], -(int)fDepth); }
+
+      //Number of CELLs that have been made
+      size_t size() const { return fNCells; }
+      bool empty() const { return fNCells == 0; }
+
+    private:
+      using Coords = std::array<double, 3>;
+      static constexpr size_t kNone = std::numeric_limits<size_t>::max();
+
+      //Children are numbered by octant: bit 0 is set for the +x half, bit 1 for +y, and bit 2 for +z.
+      struct Node
+      {
+        Node(): Cell(kNone) { std::fill(Children, Children+8, kNone); }
+
+        size_t Children[8]; //Indices into fNodes.  kNone for octants that nothing has been put into.
+        size_t Cell; //Index into fCells for leaves that have a CELL
+      };
+
+      Coords fCenter; //Center of the whole box
+      Coords fHalfWidth; //Half of the whole box's width along each axis
+      size_t fDepth; //Number of levels below the root.  The root is a leaf if this is 0.
+      std::vector<Node> fNodes; //fNodes[0] is the root.  Only the first fNodes.size() are in use.
+      std::vector<std::pair<KEY, CELL>> fCells; //Center of each leaf and its CELL.  Only the first fNCells are in use.
+      size_t fNCells; //Number of CELLs made since the last clear()
+
+      //Which octant of the box around center is pos in?  Moves center and halfWidth to that octant.
+      static size_t Descend(const KEY& pos, Coords& center, Coords& halfWidth)
+      {
+        size_t octant = 0;
+        for(size_t axis = 0; axis < 3; ++axis)
+        {
+          halfWidth[axis] *= 0.5;
+          if(pos[axis] < center[axis]) center[axis] -= halfWidth[axis];
+          else
+          {
+            center[axis] += halfWidth[axis];
+            octant |= (1 << axis);
+          }
+        }
+        return octant;
+      }
+
+      //Center and half width of octant of the box around center
+      static void Child(const size_t octant, Coords& center, Coords& halfWidth)
+      {
+        for(size_t axis = 0; axis < 3; ++axis)
+        {
+          halfWidth[axis] *= 0.5;
+          center[axis] += (octant & (1 << axis))?halfWidth[axis]:-halfWidth[axis];
+        }
+      }
+
+      //Make a default-constructed CELL at center.  Reuses memory from earlier events.
+      size_t NewCell(const Coords& center)
+      {
+        const KEY key(center[0], center[1], center[2]);
+        if(fNCells < fCells.size())
+        {
+          fCells[fNCells].first = key;
+          fCells[fNCells].second = CELL();
+        }
+        else fCells.emplace_back(key, CELL());
+        return fNCells++;
+      }
+
+      //Visit each leaf under node that the part of a segment from enter to exit passes through.  That part is already
+      //inside node's box.  Each child's part is where the segment is on that child's side of center along every
+      //axis, so the children's parts never overlap even when the segment runs along a boundary.
+      template <class VISITOR>
+      void Clip(const size_t node, const size_t level, const Coords& center, const Coords& halfWidth, const Coords& origin,
+                const Coords& dir, const double enter, const double exit, VISITOR& visit)
+      {
+        if(level == fDepth)
+        {
+          if(fNodes[node].Cell == kNone) fNodes[node].Cell = NewCell(center);
+          auto& cell = fCells[fNodes[node].Cell];
+          visit(const_cast<const KEY&>(cell.first), cell.second, enter, exit);
+          return;
+        }
+
+        for(size_t octant = 0; octant < 8; ++octant)
+        {
+          double childEnter = enter, childExit = exit;
+          for(size_t axis = 0; axis < 3 && childExit > childEnter; ++axis)
+          {
+            const bool above = octant & (1 << axis);
+            if(dir[axis] == 0.)
+            {
+              if((origin[axis] >= center[axis]) != above) childExit = childEnter; //Same choice as Descend()
+              continue;
+            }
+
+            const double split = (center[axis] - origin[axis])/dir[axis]; //Where the segment crosses center along axis
+            if(above == (dir[axis] > 0.)) childEnter = std::max(childEnter, split);
+            else childExit = std::min(childExit, split);
+          }
+          if(!(childExit > childEnter)) continue;
+
+          if(fNodes[node].Children[octant] == kNone)
+          {
+            fNodes[node].Children[octant] = fNodes.size();
+            fNodes.emplace_back(); //Invalidates references into fNodes, so only use indices here
+          }
+
+          Coords childCenter = center, childHalfWidth = halfWidth;
+          Child(octant, childCenter, childHalfWidth);
+          Clip(fNodes[node].Children[octant], level+1, childCenter, childHalfWidth, origin, dir, childEnter, childExit, visit);
+        }
+      }
+
+      //Visit each CELL under node whose center passes contains() without descending into nodes that fail overlaps().
+      template <class OVERLAPS, class CONTAINS, class VISITOR>
+      void Range(const size_t node, const size_t level, const Coords& center, const Coords& halfWidth, const OVERLAPS& overlaps,
+                 const CONTAINS& contains, VISITOR& visit)
+      {
+        if(!overlaps(center, halfWidth)) return;
+
+        if(level == fDepth)
+        {
+          if(fNodes[node].Cell != kNone && contains(center))
+          {
+            auto& cell = fCells[fNodes[node].Cell];
+            visit(const_cast<const KEY&>(cell.first), cell.second);
+          }
+          return;
+        }
+
+        for(size_t octant = 0; octant < 8; ++octant)
+        {
+          const size_t child = fNodes[node].Children[octant];
+          if(child == kNone) continue;
+
+          Coords childCenter = center, childHalfWidth = halfWidth;
+          Child(octant, childCenter, childHalfWidth);
+          Range(child, level+1, childCenter, childHalfWidth, overlaps, contains, visit);
+        }
+      }
+  };
+
+  template <class CELL, class KEY>
+  constexpr size_t Octree<CELL, KEY>::kNone;
+}
+
+#endif //RECO_OCTREE_H
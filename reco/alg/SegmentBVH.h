@@ -0,0 +1,181 @@
+//File: SegmentBVH.h
+//Brief: A SegmentBVH is a bounding volume hierarchy over line segments like TG4HitSegments.  It answers "which
+//       segments could touch this box?" by only looking at the branches of a binary tree whose bounding boxes overlap
+//       that box.  Each node's box surrounds all of the segments below it, and each split puts half of a node's
+//       segments on each side of the median along the axis where their centers are most spread out.  So, the tree is
+//       balanced no matter where in the detector the segments are.
+//
+//       A SegmentBVH only stores each segment's bounding box and an index that the caller chooses, like a row in a
+//       SegmentTable.  It never copies TG4HitSegments.  Everything is kept in flat std::vectors that clear() reuses
+//       between events.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//ROOT includes
+#include "TVector3.h"
+
+//c++ includes
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstddef>
+
+#ifndef RECO_SEGMENTBVH_H
+#define RECO_SEGMENTBVH_H
+
+namespace reco
+{
+  class SegmentBVH
+  {
+    public:
+      SegmentBVH(): fItems(), fNodes() {}
+      virtual ~SegmentBVH() = default;
+
+      //Forget every segment but keep the memory for the next event
+      void clear()
+      {
+        fItems.clear();
+        fNodes.clear();
+      }
+
+      //Add the segment from start to stop.  visit() in Overlaps() gets index back.  Call Build() after the last
+      //insert() and before any queries.
+      void insert(const size_t index, const TVector3& start, const TVector3& stop)
+      {
+        Item item;
+        item.Index = index;
+        for(size_t axis = 0; axis < 3; ++axis)
+        {
+          item.Low[axis] = std::min(start[axis], stop[axis]);
+          item.High[axis] = std::max(start[axis], stop[axis]);
+        }
+        fItems.push_back(item);
+      }
+
+      //Make the tree from every segment that was insert()ed since the last clear()
+      void Build()
+      {
+        fNodes.clear();
+        if(fItems.empty()) return;
+        fNodes.reserve(2*fItems.size()/kLeafSize+1);
+        BuildNode(0, fItems.size());
+      }
+
+      //Call visit(size_t index) for every segment whose bounding box overlaps the box from low to high.  Segments in
+      //that list might still miss the box, but every segment that touches it is in the list.
+      template <class VISITOR>
+      void Overlaps(const TVector3& low, const TVector3& high, VISITOR&& visit) const
+      {
+        if(fNodes.empty()) return;
+        const Coords boxLow{{low[0], low[1], low[2]}}, boxHigh{{high[0], high[1], high[2]}};
+
+        //The tree is balanced, so its depth is about log2(size()/kLeafSize).  This stack is deep enough for any
+        //number of segments that fits in memory.
+        std::array<size_t, 128> stack;
+        size_t nStack = 0;
+        stack[nStack++] = 0;
+        while(nStack > 0)
+        {
+          const Node& node = fNodes[stack[--nStack]];
+          if(!Overlap(node.Low, node.High, boxLow, boxHigh)) continue;
+
+          if(node.Left == kLeaf)
+          {
+            for(size_t item = node.Begin; item < node.End; ++item)
+            {
+              if(Overlap(fItems[item].Low, fItems[item].High, boxLow, boxHigh)) visit(fItems[item].Index);
+            }
+          }
+          else
+          {
+            stack[nStack++] = node.Right;
+            stack[nStack++] = node.Left;
+          }
+        }
+      }
+
+      size_t size() const { return fItems.size(); }
+      bool empty() const { return fItems.empty(); }
+
+    private:
+      using Coords = std::array<double, 3>;
+      enum : size_t { kLeafSize = 4 }; //Nodes with this many segments or fewer aren't split
+      enum : size_t { kLeaf = 0 }; //Children of nodes without children.  The root is never anyone's child.
+
+      struct Item
+      {
+        Coords Low; //Smallest coordinates of this segment along each axis
+        Coords High; //Largest coordinates of this segment along each axis
+        size_t Index; //Whatever the caller told insert() about this segment
+      };
+
+      struct Node
+      {
+        Coords Low; //Bounding box of every segment below this node
+        Coords High;
+        size_t Begin; //This node's segments are fItems[Begin, End)
+        size_t End;
+        size_t Left; //Index of each child in fNodes.  Both are kLeaf if this is a leaf.
+        size_t Right;
+      };
+
+      std::vector<Item> fItems; //Segments sorted so that each node's segments are next to each other
+      std::vector<Node> fNodes; //fNodes[0] is the root
+
+      static bool Overlap(const Coords& low, const Coords& high, const Coords& otherLow, const Coords& otherHigh)
+      {
+        for(size_t axis = 0; axis < 3; ++axis)
+        {
+          if(high[axis] < otherLow[axis] || low[axis] > otherHigh[axis]) return false;
+        }
+        return true;
+      }
+
+      //Make a node for fItems[begin, end) and everything below it.  Returns its index in fNodes.
+      size_t BuildNode(const size_t begin, const size_t end)
+      {
+        const size_t index = fNodes.size();
+        fNodes.emplace_back();
+        Coords low = fItems[begin].Low, high = fItems[begin].High, centerLow, centerHigh;
+        for(size_t axis = 0; axis < 3; ++axis) centerLow[axis] = centerHigh[axis] = Center(fItems[begin], axis);
+        for(size_t item = begin+1; item < end; ++item)
+        {
+          for(size_t axis = 0; axis < 3; ++axis)
+          {
+            low[axis] = std::min(low[axis], fItems[item].Low[axis]);
+            high[axis] = std::max(high[axis], fItems[item].High[axis]);
+            centerLow[axis] = std::min(centerLow[axis], Center(fItems[item], axis));
+            centerHigh[axis] = std::max(centerHigh[axis], Center(fItems[item], axis));
+          }
+        }
+
+        fNodes[index].Low = low;
+        fNodes[index].High = high;
+        fNodes[index].Begin = begin;
+        fNodes[index].End = end;
+        fNodes[index].Left = kLeaf;
+        fNodes[index].Right = kLeaf;
+        if(end - begin <= kLeafSize) return index;
+
+        //Split at the median along the axis where segments' centers are most spread out
+        size_t axis = 0;
+        for(size_t other = 1; other < 3; ++other)
+        {
+          if(centerHigh[other] - centerLow[other] > centerHigh[axis] - centerLow[axis]) axis = other;
+        }
+
+        const size_t mid = begin + (end - begin)/2;
+        std::nth_element(fItems.begin() + begin, fItems.begin() + mid, fItems.begin() + end,
+                         [axis](const Item& first, const Item& second) { return Center(first, axis) < Center(second, axis); });
+
+        const size_t left = BuildNode(begin, mid); //fNodes might move here, so don't keep references into it
+        const size_t right = BuildNode(mid, end);
+        fNodes[index].Left = left;
+        fNodes[index].Right = right;
+        return index;
+      }
+
+      static double Center(const Item& item, const size_t axis) { return item.Low[axis] + item.High[axis]; } //Twice the center is good enough to compare
+  };
+}
+
+#endif //RECO_SEGMENTBVH_H
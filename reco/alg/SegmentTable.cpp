@@ -0,0 +1,79 @@
+//File: SegmentTable.cpp
+//Brief: Every TG4HitSegment in an event as columns in the fiducial volume's coordinate system.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//Include header
+#include "reco/alg/SegmentTable.h"
+
+//edepsim includes
+#include "TG4Event.h"
+#include "TG4HitSegment.h"
+
+//ROOT includes
+#include "TGeoMatrix.h"
+#include "TGeoShape.h"
+
+namespace reco
+{
+  SegmentTable::SegmentTable(): StartX(), StartY(), StartZ(), StopX(), StopY(), StopZ(), StartT(), StopT(), Energy(), SecondaryEnergy(),
+                                PrimaryId(), Detector(), Fiducial(), Segment(), fRequested(false), fDetectorNames(), fDetectorOffsets(1, 0)
+  {
+  }
+
+  void SegmentTable::Fill(const TG4Event& event, const geo::GeoService::Volume& fiducial)
+  {
+    for(auto column: {&StartX, &StartY, &StartZ, &StopX, &StopY, &StopZ, &StartT, &StopT, &Energy, &SecondaryEnergy}) column->clear();
+    PrimaryId.clear();
+    Detector.clear();
+    Fiducial.clear();
+    Segment.clear();
+    fDetectorNames.clear();
+    fDetectorOffsets.assign(1, 0);
+
+    for(const auto& det: event.SegmentDetectors)
+    {
+      const int whichDet = fDetectorNames.size();
+      fDetectorNames.push_back(det.first);
+      for(const auto& seg: det.second)
+      {
+        #ifdef EDEPSIM_FORCE_PRIVATE_FIELDS
+        const auto& segStart = seg.GetStart();
+        const auto& segStop = seg.GetStop();
+        PrimaryId.push_back(seg.GetPrimaryId());
+        Energy.push_back(seg.GetEnergyDeposit());
+        SecondaryEnergy.push_back(seg.GetSecondaryDeposit());
+        #else
+        const auto& segStart = seg.Start;
+        const auto& segStop = seg.Stop;
+        PrimaryId.push_back(seg.PrimaryId);
+        Energy.push_back(seg.EnergyDeposit);
+        SecondaryEnergy.push_back(seg.SecondaryDeposit);
+        #endif
+
+        const double master[] = {segStart.X(), segStart.Y(), segStart.Z(), segStop.X(), segStop.Y(), segStop.Z()};
+        double local[6];
+        fiducial.Matrix.MasterToLocal(master, local);
+        fiducial.Matrix.MasterToLocal(master+3, local+3);
+
+        StartX.push_back(local[0]);
+        StartY.push_back(local[1]);
+        StartZ.push_back(local[2]);
+        StopX.push_back(local[3]);
+        StopY.push_back(local[4]);
+        StopZ.push_back(local[5]);
+        StartT.push_back(segStart.T());
+        StopT.push_back(segStop.T());
+        Detector.push_back(whichDet);
+        Fiducial.push_back(fiducial.Shape->Contains(local));
+        Segment.push_back(&seg);
+      }
+      fDetectorOffsets.push_back(StartX.size());
+    }
+  }
+
+  LocalSegment SegmentTable::Local(const size_t row) const
+  {
+    const double start[] = {StartX[row], StartY[row], StartZ[row]}, stop[] = {StopX[row], StopY[row], StopZ[row]};
+    return LocalSegment(start, stop, StartT[row], StopT[row]);
+  }
+}
@@ -0,0 +1,72 @@
+//File: SegmentTable.h
+//Brief: A SegmentTable holds every TG4HitSegment in the current event as columns of numbers in the fiducial volume's 
+//       coordinate system.  Hit-making Reconstructors used to each loop over TG4Event::SegmentDetectors, copy Start, 
+//       Stop, PrimaryId, and energy out of every TG4HitSegment, and call MasterToLocal() on them.  Running 3 hit 
+//       algorithms to compare them did all of that 3 times.  Now, the driver application fills one SegmentTable per 
+//       event, and every plugin that asked for it reads the same columns.  
+//
+//       Rows are grouped by sensitive detector in the same order as TG4Event::SegmentDetectors.  Each column is a 
+//       contiguous std::vector, so loops over one column at a time are easy for the compiler to vectorize.  
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//local includes
+#include "reco/alg/GeoService.h"
+#include "reco/alg/LocalSegment.h"
+
+//c++ includes
+#include <vector>
+#include <string>
+
+#ifndef RECO_SEGMENTTABLE_H
+#define RECO_SEGMENTTABLE_H
+
+class TG4Event;
+class TG4HitSegment;
+
+namespace reco
+{
+  class SegmentTable
+  {
+    public:
+      SegmentTable();
+      virtual ~SegmentTable() = default;
+
+      //Plugins call this through plgn::Reconstructor::UseSegments() when they are created.  The driver application 
+      //doesn't bother filling a SegmentTable that nobody asked for.  
+      void Request() { fRequested = true; }
+      bool Requested() const { return fRequested; }
+
+      //Replace all rows with the TG4HitSegments in event.  Positions are converted to fiducial's coordinate system.  
+      //Keeps memory around between events.
+      void Fill(const TG4Event& event, const geo::GeoService::Volume& fiducial);
+
+      size_t size() const { return StartX.size(); }
+
+      //Rows [DetectorBegin(det), DetectorEnd(det)) came from the det-th sensitive detector
+      size_t NDetectors() const { return fDetectorNames.size(); }
+      const std::string& DetectorName(const size_t det) const { return fDetectorNames[det]; }
+      size_t DetectorBegin(const size_t det) const { return fDetectorOffsets[det]; }
+      size_t DetectorEnd(const size_t det) const { return fDetectorOffsets[det+1]; }
+
+      //Everything GridHits needs to know about where a row is without converting it to local coordinates again
+      LocalSegment Local(const size_t row) const;
+
+      //Columns.  Element i of each column describes the same TG4HitSegment.
+      std::vector<double> StartX, StartY, StartZ; //Where each segment starts in the fiducial volume's coordinate system
+      std::vector<double> StopX, StopY, StopZ; //Where each segment stops in the fiducial volume's coordinate system
+      std::vector<double> StartT, StopT; //Times when each segment starts and stops
+      std::vector<double> Energy; //TG4HitSegment::EnergyDeposit
+      std::vector<double> SecondaryEnergy; //TG4HitSegment::SecondaryDeposit
+      std::vector<int> PrimaryId; //TG4HitSegment::PrimaryId
+      std::vector<int> Detector; //Index of the sensitive detector each segment came from
+      std::vector<char> Fiducial; //Whether each segment starts inside the fiducial volume
+      std::vector<const TG4HitSegment*> Segment; //Observer pointers to the original TG4HitSegments for algorithms that still need them
+
+    private:
+      bool fRequested; //Has any plugin asked for this SegmentTable?
+      std::vector<std::string> fDetectorNames; //Name of each sensitive detector in the current event
+      std::vector<size_t> fDetectorOffsets; //First row from each sensitive detector plus one past the last row
+  };
+}
+
+#endif //RECO_SEGMENTTABLE_H
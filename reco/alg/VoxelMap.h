@@ -0,0 +1,155 @@
+//File: VoxelMap.h
+//Brief: A VoxelMap is a sparse 3D grid of VALUEs indexed by 3 integers like GridHits::Triple.  It replaces
+//       std::map<Triple, VALUE> in algorithms that look up lots of voxels for every TG4HitSegment.  Each key is
+//       packed into one 64-bit integer with Morton (Z-order) encoding, and keys are found in an open-addressing hash
+//       table with linear probing.  VALUEs live in one contiguous std::vector in the order they were first inserted.
+//       clear() keeps all memory around, so a VoxelMap that is a member of a plugin stops allocating after the
+//       first few events.
+//
+//       KEY must have int members named First, Second, and Third and a constructor that takes all 3.  Each index
+//       has to be within +/- 2^20 of 0.  That's 10km with 1cm cubes.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//util includes
+#include "Base/exception.h"
+
+//c++ includes
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <algorithm>
+
+#ifndef RECO_VOXELMAP_H
+#define RECO_VOXELMAP_H
+
+namespace reco
+{
+  template <class KEY, class VALUE>
+  class VoxelMap
+  {
+    public:
+      using value_type = std::pair<KEY, VALUE>;
+      using iterator = typename std::vector<value_type>::iterator;
+      using const_iterator = typename std::vector<value_type>::const_iterator;
+
+      VoxelMap(): fSlotKeys(16, kEmpty), fSlotIndices(16, 0), fEntries(), fSize(0) {}
+      virtual ~VoxelMap() = default;
+
+      //Like std::map::operator[].  Inserts a default-constructed VALUE if there is nothing at pos yet.
+      VALUE& operator [](const KEY& pos)
+      {
+        const uint64_t key = Encode(pos);
+        size_t slot = FindSlot(key);
+        if(fSlotKeys[slot] != kEmpty) return fEntries[fSlotIndices[slot]].second;
+
+        //Keep at least half of the slots empty so that probes stay short
+        if(2*(fSize+1) > fSlotKeys.size())
+        {
+          Rehash(2*fSlotKeys.size());
+          slot = FindSlot(key);
+        }
+
+        fSlotKeys[slot] = key;
+        fSlotIndices[slot] = fSize;
+        if(fSize < fEntries.size()) //Reuse an entry from an earlier event
+        {
+          fEntries[fSize].first = pos;
+          fEntries[fSize].second = VALUE();
+        }
+        else fEntries.emplace_back(pos, VALUE());
+
+        return fEntries[fSize++].second;
+      }
+
+      //Returns nullptr if there is nothing at pos.  Never inserts anything.
+      const value_type* find(const KEY& pos) const
+      {
+        const size_t slot = FindSlot(Encode(pos));
+        if(fSlotKeys[slot] == kEmpty) return nullptr;
+        return &fEntries[fSlotIndices[slot]];
+      }
+
+      //Forget every voxel, but keep the memory for the next event
+      void clear()
+      {
+        std::fill(fSlotKeys.begin(), fSlotKeys.end(), kEmpty);
+        fSize = 0;
+      }
+
+      size_t size() const { return fSize; }
+      bool empty() const { return fSize == 0; }
+
+      //Iterate over (KEY, VALUE) pairs in the order they were inserted
+      iterator begin() { return fEntries.begin(); }
+      iterator end() { return fEntries.begin() + fSize; }
+      const_iterator begin() const { return fEntries.begin(); }
+      const_iterator end() const { return fEntries.begin() + fSize; }
+
+      //Interleave the bits of pos's 3 indices so that nearby voxels tend to have nearby keys.
+      static uint64_t Encode(const KEY& pos)
+      {
+        return Spread(Bias(pos.First)) | (Spread(Bias(pos.Second)) << 1) | (Spread(Bias(pos.Third)) << 2);
+      }
+
+    private:
+      static constexpr uint64_t kEmpty = ~uint64_t(0); //Encode() only ever uses the lowest 63 bits
+      static constexpr int kOffset = 1 << 20; //Shift indices so that they're never negative
+
+      static uint64_t Bias(const int index)
+      {
+        if(index < -kOffset || index >= kOffset)
+        {
+          throw util::exception("VoxelMap") << "Voxel index " << index << " is too far from the origin to fit in a Morton key.\n";
+        }
+        return uint64_t(index + kOffset);
+      }
+
+      //Put 2 zeroes between each of the lowest 21 bits of bits
+      static uint64_t Spread(uint64_t bits)
+      {
+        bits &= 0x1fffff;
+        bits = (bits | (bits << 32)) & 0x1f00000000ffffULL;
+        bits = (bits | (bits << 16)) & 0x1f0000ff0000ffULL;
+        bits = (bits | (bits << 8)) & 0x100f00f00f00f00fULL;
+        bits = (bits | (bits << 4)) & 0x10c30c30c30c30c3ULL;
+        bits = (bits | (bits << 2)) & 0x1249249249249249ULL;
+        return bits;
+      }
+
+      //Index of the slot that either holds key or is the empty slot where key would go
+      size_t FindSlot(const uint64_t key) const
+      {
+        //Morton keys of neighboring voxels differ mostly in their low bits.  Mix them up before picking a slot.
+        const size_t mask = fSlotKeys.size() - 1;
+        size_t slot = ((key * 0x9e3779b97f4a7c15ULL) >> 32) & mask;
+        while(fSlotKeys[slot] != kEmpty && fSlotKeys[slot] != key) slot = (slot + 1) & mask;
+        return slot;
+      }
+
+      void Rehash(const size_t nSlots)
+      {
+        fSlotKeys.assign(nSlots, kEmpty);
+        fSlotIndices.assign(nSlots, 0);
+        for(size_t entry = 0; entry < fSize; ++entry)
+        {
+          const uint64_t key = Encode(fEntries[entry].first);
+          const size_t slot = FindSlot(key);
+          fSlotKeys[slot] = key;
+          fSlotIndices[slot] = entry;
+        }
+      }
+
+      std::vector<uint64_t> fSlotKeys; //Hash table of Morton keys.  Size is always a power of 2.
+      std::vector<size_t> fSlotIndices; //Index into fEntries for each slot in fSlotKeys
+      std::vector<value_type> fEntries; //Every voxel in insertion order.  Only the first fSize are in use.
+      size_t fSize; //Number of voxels in this map
+  };
+
+  template <class KEY, class VALUE>
+  constexpr uint64_t VoxelMap<KEY, VALUE>::kEmpty;
+
+  template <class KEY, class VALUE>
+  constexpr int VoxelMap<KEY, VALUE>::kOffset;
+}
+
+#endif //RECO_VOXELMAP_H
@@ -0,0 +1,167 @@
+//File: VoxelSums.h
+//Brief: A VoxelSums counts how many of a set of voxels are inside any box in O(1) time.  It is a 3D summed-area
+//       table: each entry is the number of voxels below and behind it, so the count in a box is 8 lookups with
+//       inclusion-exclusion instead of one VoxelMap::find() for every voxel in the box.  GridNeutronHits uses it to
+//       ask "is there a non-neutron hit within NeighborCut cubes?" without a cost that grows like NeighborCut^3.
+//
+//       The table only has rows and columns for coordinates that some voxel actually uses.  So, 2 voxels at
+//       opposite ends of the detector need a 2x2x2 table instead of one that spans the whole detector.  Each axis
+//       also keeps a lookup table from coordinate to row so that queries never have to search.
+//
+//       KEY must have int members named First, Second, and Third and a constructor that takes all 3 like
+//       GridHits::Triple.  Keeps all memory around between events.  Holds up to 2^32 voxels.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//c++ includes
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef RECO_VOXELSUMS_H
+#define RECO_VOXELSUMS_H
+
+namespace reco
+{
+  template <class KEY>
+  class VoxelSums
+  {
+    public:
+      VoxelSums(): fVoxels(), fCoords(), fRanks(), fMin{{0, 0, 0}}, fSums() {}
+      virtual ~VoxelSums() = default;
+
+      //Start a new event
+      void clear()
+      {
+        fVoxels.clear();
+        fSums.assign(1, 0);
+        for(auto& coords: fCoords) coords.clear();
+        for(auto& ranks: fRanks) ranks.clear();
+      }
+
+      //Count voxel in this VoxelSums.  Call Build() after the last insert() and before any queries.  Don't insert
+      //the same voxel twice.
+      void insert(const KEY& voxel) { fVoxels.push_back(voxel); }
+
+      //Make the summed-area table from every voxel that was insert()ed since the last clear()
+      void Build()
+      {
+        //Which coordinates are used along each axis?
+        for(size_t axis = 0; axis < 3; ++axis)
+        {
+          auto& coords = fCoords[axis];
+          coords.clear();
+          for(const auto& voxel: fVoxels) coords.push_back(Get(voxel, axis));
+          std::sort(coords.begin(), coords.end());
+          coords.erase(std::unique(coords.begin(), coords.end()), coords.end());
+
+          //fRanks[axis][c - fMin[axis]] is the number of used coordinates <= c
+          auto& ranks = fRanks[axis];
+          ranks.clear();
+          if(coords.empty()) continue;
+          fMin[axis] = coords.front();
+          ranks.assign(coords.back() - coords.front() + 1, 0);
+          for(const auto coord: coords) ranks[coord - fMin[axis]] = 1;
+          for(size_t pos = 1; pos < ranks.size(); ++pos) ranks[pos] += ranks[pos-1];
+        }
+
+        //Put each voxel in the table, then sum along each axis in turn
+        const size_t nX = fCoords[0].size()+1, nY = fCoords[1].size()+1, nZ = fCoords[2].size()+1;
+        fSums.assign(nX*nY*nZ, 0);
+        for(const auto& voxel: fVoxels) ++fSums[Index(Rank(voxel.First, 0), Rank(voxel.Second, 1), Rank(voxel.Third, 2))];
+
+        for(size_t x = 1; x < nX; ++x) for(size_t y = 1; y < nY; ++y) for(size_t z = 1; z < nZ; ++z) fSums[Index(x, y, z)] += fSums[Index(x, y, z-1)];
+        for(size_t x = 1; x < nX; ++x) for(size_t y = 1; y < nY; ++y) for(size_t z = 1; z < nZ; ++z) fSums[Index(x, y, z)] += fSums[Index(x, y-1, z)];
+        for(size_t x = 1; x < nX; ++x) for(size_t y = 1; y < nY; ++y) for(size_t z = 1; z < nZ; ++z) fSums[Index(x, y, z)] += fSums[Index(x-1, y, z)];
+      }
+
+      //Number of voxels with every index between low's and high's, inclusive.  O(1).
+      size_t Count(const KEY& low, const KEY& high) const
+      {
+        if(fVoxels.empty()) return 0;
+        return Sum(Rank(low.First-1, 0), Rank(high.First, 0), Rank(low.Second-1, 1), Rank(high.Second, 1),
+                   Rank(low.Third-1, 2), Rank(high.Third, 2));
+      }
+
+      //Call visit(KEY) with every voxel between low and high, inclusive, in the order that GridHits::Triple sorts in.
+      //Skips empty parts of the box using Count(), so it takes time proportional to the number of voxels found rather
+      //than to the size of the box.
+      template <class FUNC>
+      void ForEach(const KEY& low, const KEY& high, FUNC&& visit) const
+      {
+        if(fVoxels.empty()) return;
+        Visit({{Rank(low.First-1, 0), Rank(low.Second-1, 1), Rank(low.Third-1, 2)}},
+              {{Rank(high.First, 0), Rank(high.Second, 1), Rank(high.Third, 2)}}, visit);
+      }
+
+      size_t size() const { return fVoxels.size(); }
+      bool empty() const { return fVoxels.empty(); }
+
+    private:
+      using Box = std::array<size_t, 3>; //Ranks along each axis
+
+      std::vector<KEY> fVoxels; //Every voxel insert()ed since the last clear()
+      std::array<std::vector<int>, 3> fCoords; //Sorted coordinates that voxels use along each axis
+      std::array<std::vector<size_t>, 3> fRanks; //Number of coordinates in fCoords <= each coordinate from fMin to the largest one
+      std::array<int, 3> fMin; //Smallest coordinate along each axis
+      std::vector<uint32_t> fSums; //fSums[Index(x, y, z)] is the number of voxels with ranks <= (x, y, z).  Rank 0 is always empty.
+
+      static int Get(const KEY& voxel, const size_t axis)
+      {
+        if(axis == 0) return voxel.First;
+        if(axis == 1) return voxel.Second;
+        return voxel.Third;
+      }
+
+      //Number of coordinates that voxels use along axis that are <= coord
+      size_t Rank(const int coord, const size_t axis) const
+      {
+        if(coord < fMin[axis]) return 0;
+        const size_t pos = coord - fMin[axis];
+        if(pos >= fRanks[axis].size()) return fCoords[axis].size();
+        return fRanks[axis][pos];
+      }
+
+      size_t Index(const size_t x, const size_t y, const size_t z) const
+      {
+        return (x*(fCoords[1].size()+1) + y)*(fCoords[2].size()+1) + z;
+      }
+
+      //Number of voxels with ranks in (xLow, xHigh] x (yLow, yHigh] x (zLow, zHigh]
+      size_t Sum(const size_t xLow, const size_t xHigh, const size_t yLow, const size_t yHigh, const size_t zLow, const size_t zHigh) const
+      {
+        if(xLow >= xHigh || yLow >= yHigh || zLow >= zHigh) return 0;
+        return fSums[Index(xHigh, yHigh, zHigh)] - fSums[Index(xLow, yHigh, zHigh)] - fSums[Index(xHigh, yLow, zHigh)]
+             - fSums[Index(xHigh, yHigh, zLow)] + fSums[Index(xLow, yLow, zHigh)] + fSums[Index(xLow, yHigh, zLow)]
+             + fSums[Index(xHigh, yLow, zLow)] - fSums[Index(xLow, yLow, zLow)];
+      }
+
+      //Split the box (low, high] in half along the first axis that's wider than 1 rank until each piece is either
+      //empty or a single voxel.  Splitting x, then y, then z keeps voxels in order.
+      template <class FUNC>
+      void Visit(const Box& low, const Box& high, FUNC& visit) const
+      {
+        if(Sum(low[0], high[0], low[1], high[1], low[2], high[2]) == 0) return;
+
+        for(size_t axis = 0; axis < 3; ++axis)
+        {
+          if(high[axis] - low[axis] > 1)
+          {
+            const size_t mid = low[axis] + (high[axis] - low[axis])/2;
+            Box lowHalf = high, highHalf = low;
+            lowHalf[axis] = mid;
+            highHalf[axis] = mid;
+            Visit(low, lowHalf, visit);
+            Visit(highHalf, high, visit);
+            return;
+          }
+        }
+
+        //Rank r is the coordinate at fCoords[r-1]
+        visit(KEY(fCoords[0][high[0]-1], fCoords[1][high[1]-1], fCoords[2][high[2]-1]));
+      }
+  };
+}
+
+#endif //RECO_VOXELSUMS_H
@@ -0,0 +1,281 @@
+//File: BestCandidatesMatchOdometer.cpp
+//Brief: Makes sure that reco::BestCandidates groups clusters into exactly the same candidates as CandFromPDF's old search.
+//       The old search tried every way of taking one cluster or nothing from each time bin like an odometer and kept the
+//       first combination with the largest log-likelihood.  This test copies that code, but it looks up each cluster's
+//       term in a table instead of a TH2D.  Both run on a few hand-made events with ties, NaN and -infinity terms, and
+//       clusters that are all worse than the penalty, and on fake events with terms picked from a short list so that
+//       there are lots of exact ties.  Terms are never positive like the log of a normalized PDF.
+//
+//       Then it checks the WorkBudget fallback: running out of budget only on the last pass changes nothing, running out
+//       right away takes the best cluster from every time bin, every cluster still ends up in exactly one candidate, and
+//       NFallbacks() counts events instead of candidates.  Returns non-zero if anything is different.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//reco includes
+#include "reco/alg/BestCandidates.h"
+
+//c++ includes
+#include <map>
+#include <vector>
+#include <random>
+#include <string>
+#include <limits>
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+namespace
+{
+  using Cands = std::vector<std::vector<size_t>>;
+
+  const double inf = std::numeric_limits<double>::infinity();
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+
+  struct Event
+  {
+    std::vector<double> terms;
+    std::vector<unsigned int> timeBins;
+    double penalty;
+  };
+
+  //CandFromPDF::DoReconstruct() before BestCandidates.  terms[cluster] replaces log10() of the PDF's bin content.
+  Cands Odometer(const Event& event)
+  {
+    std::map<unsigned int, std::vector<size_t>> timeBinnedClusters;
+    for(size_t cluster = 0; cluster < event.terms.size(); ++cluster) timeBinnedClusters[event.timeBins[cluster]].push_back(cluster);
+
+    Cands cands;
+    auto empty = [&timeBinnedClusters]()
+                 {
+                   return std::none_of(timeBinnedClusters.begin(), timeBinnedClusters.end(), [](const auto& bin) { return !bin.second.empty(); });
+                 };
+    while(!empty())
+    {
+      std::vector<std::vector<size_t>::iterator> currentCand, begin, end;
+      for(auto& bin: timeBinnedClusters)
+      {
+        currentCand.push_back(bin.second.begin());
+        begin.push_back(bin.second.begin());
+        end.push_back(bin.second.end());
+      }
+
+      auto best = currentCand;
+      double bestLikelihood = -std::numeric_limits<double>::max();
+
+      while(currentCand != end)
+      {
+        double likelihood = 0.;
+        for(size_t pos = 0; pos < currentCand.size() && likelihood > bestLikelihood; ++pos)
+        {
+          const auto iter = currentCand[pos];
+          if(iter == end[pos]) likelihood += event.penalty;
+          else likelihood += event.terms[*iter];
+        }
+
+        if(likelihood > bestLikelihood)
+        {
+          best = currentCand;
+          bestLikelihood = likelihood;
+        }
+
+        for(int pos = currentCand.size()-1; pos > -1;)
+        {
+          if(currentCand[pos] == end[pos])
+          {
+            currentCand[pos] = begin[pos];
+            --pos;
+          }
+          else
+          {
+            ++currentCand[pos];
+            break;
+          }
+        }
+      }
+
+      std::vector<size_t> bestCand;
+      for(size_t pos = 0; pos < best.size(); ++pos)
+      {
+        if(best[pos] != end[pos]) bestCand.push_back(*(best[pos]));
+      }
+      cands.push_back(bestCand);
+
+      for(const auto cluster: bestCand)
+      {
+        auto& values = timeBinnedClusters[event.timeBins[cluster]];
+        values.erase(std::find(values.begin(), values.end(), cluster));
+      }
+    }
+
+    return cands;
+  }
+
+  //How CandFromPDF uses BestCandidates now
+  Cands New(reco::BestCandidates& best, const Event& event, bool& fellBack)
+  {
+    best.clear();
+    for(size_t cluster = 0; cluster < event.terms.size(); ++cluster) best.Add(event.terms[cluster], event.timeBins[cluster]);
+
+    Cands cands;
+    fellBack = best.Find(event.penalty, [&cands](const std::vector<size_t>& cand) { cands.push_back(cand); });
+    return cands;
+  }
+
+  std::string Print(const Cands& cands)
+  {
+    std::string result;
+    for(const auto& cand: cands)
+    {
+      result += "(";
+      for(const auto cluster: cand) result += " " + std::to_string(cluster);
+      result += " )";
+    }
+    return result;
+  }
+
+  //Hand-made events for the cases the old search handled implicitly
+  std::vector<std::pair<std::string, Event>> HandMade()
+  {
+    std::vector<std::pair<std::string, Event>> events;
+
+    events.emplace_back("ties within and between time bins", Event{{-1., -1., -1., -0.5, -0.5, -1.}, {0, 0, 1, 1, 2, 2}, -2.});
+    events.emplace_back("terms exactly at the penalty", Event{{-2., -2., -3., -1.}, {0, 1, 1, 2}, -2.});
+    events.emplace_back("NaN and -infinity terms", Event{{nan, -1., -inf, -inf, nan, -0.5}, {0, 0, 1, 1, 2, 3}, -2.});
+    events.emplace_back("no time bin beats the penalty", Event{{-3., -2.5, -4., -2.5, -5.}, {0, 1, 1, 2, 3}, -2.});
+    events.emplace_back("every candidate is impossible", Event{{-inf, nan, -inf, nan}, {0, 0, 1, 2}, -2.});
+    events.emplace_back("one cluster", Event{{-1.}, {7}, -2.});
+    events.emplace_back("no clusters", Event{{}, {}, -2.});
+
+    return events;
+  }
+
+  //Fake events with a handful of time bins and terms from a short list so that many sums tie exactly
+  Event FakeEvent(std::mt19937& gen)
+  {
+    const std::vector<double> values = {0., -0.5, -1., -1.5, -2., -2.5, -3., -4., -inf, nan};
+    const std::vector<double> penalties = {-1., -2., -2.5};
+    std::uniform_int_distribution<size_t> nClusters(1, 10), whichValue(0, values.size()-1), whichPenalty(0, penalties.size()-1);
+    std::uniform_int_distribution<unsigned int> timeBin(0, 5);
+
+    Event event;
+    const size_t nCluster = nClusters(gen);
+    for(size_t cluster = 0; cluster < nCluster; ++cluster)
+    {
+      event.terms.push_back(values[whichValue(gen)]);
+      event.timeBins.push_back(timeBin(gen));
+    }
+    event.penalty = penalties[whichPenalty(gen)];
+    return event;
+  }
+
+  //Every cluster has to be in exactly one candidate, and no candidate has 2 clusters from the same time bin
+  bool Partitions(const Cands& cands, const Event& event)
+  {
+    std::vector<size_t> used(event.terms.size(), 0);
+    for(const auto& cand: cands)
+    {
+      if(cand.empty()) return false;
+      for(size_t pos = 0; pos < cand.size(); ++pos)
+      {
+        ++used[cand[pos]];
+        if(pos > 0 && !(event.timeBins[cand[pos-1]] < event.timeBins[cand[pos]])) return false;
+      }
+    }
+    return std::all_of(used.begin(), used.end(), [](const size_t count) { return count == 1; });
+  }
+
+  //Number of time bins BestCandidates looks at when it doesn't run out of budget
+  size_t Work(const Cands& cands, const Event& event)
+  {
+    std::vector<unsigned int> bins(event.timeBins);
+    std::sort(bins.begin(), bins.end());
+    const size_t nBins = std::unique(bins.begin(), bins.end()) - bins.begin();
+    return nBins*(cands.size()+1); //The last pass finds that every cluster is in a candidate
+  }
+}
+
+int main()
+{
+  size_t nFailed = 0, nEvents = 0;
+  reco::BestCandidates best(std::numeric_limits<size_t>::max()); //Reused between events like CandFromPDF does
+
+  std::vector<std::pair<std::string, Event>> events = HandMade();
+  std::mt19937 gen(20200916);
+  for(size_t event = 0; event < 5000; ++event) events.emplace_back("fake event " + std::to_string(event), FakeEvent(gen));
+
+  for(const auto& event: events)
+  {
+    ++nEvents;
+    bool fellBack = false;
+    const auto expected = Odometer(event.second);
+    const auto got = New(best, event.second, fellBack);
+    if(got != expected || fellBack)
+    {
+      ++nFailed;
+      std::cerr << "BestCandidates found" << Print(got) << ", but the old search found" << Print(expected) << " for " << event.first << ".\n";
+    }
+  }
+  if(best.NFallbacks() != 0)
+  {
+    ++nFailed;
+    std::cerr << "BestCandidates fell back " << best.NFallbacks() << " times without a work budget.\n";
+  }
+
+  //Run out of budget on the last pass, which has nothing left to group, and then right away
+  size_t nFallbacks = 0;
+  for(const auto& event: events)
+  {
+    if(event.second.terms.empty()) continue;
+
+    bool fellBack = false;
+    const auto expected = Odometer(event.second);
+    const auto work = Work(expected, event.second);
+
+    reco::BestCandidates enough(work), lastPass(work-1), none(0);
+    const auto withEnough = New(enough, event.second, fellBack);
+    if(withEnough != expected || fellBack || enough.NFallbacks() != 0)
+    {
+      ++nFailed;
+      std::cerr << "BestCandidates fell back with a WorkBudget of exactly " << work << " for " << event.first << ".\n";
+    }
+
+    const auto withLastPass = New(lastPass, event.second, fellBack);
+    if(withLastPass != expected || !fellBack || lastPass.NFallbacks() != 1)
+    {
+      ++nFailed;
+      std::cerr << "Running out of WorkBudget on the last pass found" << Print(withLastPass) << " instead of" << Print(expected)
+                << " and fell back " << lastPass.NFallbacks() << " times for " << event.first << ".\n";
+    }
+
+    //Greedy candidates take the best remaining cluster from every time bin, so the first one has a cluster from every time bin
+    const auto greedy = New(none, event.second, fellBack);
+    std::vector<unsigned int> bins(event.second.timeBins);
+    std::sort(bins.begin(), bins.end());
+    const size_t nBins = std::unique(bins.begin(), bins.end()) - bins.begin();
+    if(!fellBack || none.NFallbacks() != 1 || !Partitions(greedy, event.second) || greedy.front().size() != nBins)
+    {
+      ++nFailed;
+      std::cerr << "Grouping greedily found" << Print(greedy) << " and fell back " << none.NFallbacks() << " times for " << event.first << ".\n";
+    }
+
+    //The same BestCandidates has to count each event once no matter how many candidates it grouped greedily
+    reco::BestCandidates shared(0);
+    for(size_t repeat = 0; repeat < 3; ++repeat) New(shared, event.second, fellBack);
+    nFallbacks += shared.NFallbacks();
+    if(shared.NFallbacks() != 3)
+    {
+      ++nFailed;
+      std::cerr << "A BestCandidates with no WorkBudget counted " << shared.NFallbacks() << " fallbacks in 3 events for " << event.first << ".\n";
+    }
+  }
+
+  if(nFailed > 0)
+  {
+    std::cerr << nFailed << " checks failed on " << nEvents << " events.\n";
+    return 1;
+  }
+
+  std::cout << "BestCandidates matched the old search on all " << nEvents << " events, and the WorkBudget fallback "
+            << "grouped every cluster and was counted " << nFallbacks << " times.\n";
+  return 0;
+}
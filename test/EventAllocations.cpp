@@ -0,0 +1,106 @@
+//File: EventAllocations.cpp
+//Brief: Makes sure that reading a plgn::Event the way plugins do never allocates memory.  Plugins used to write 
+//       const auto trajs = fEvent->Trajectories, which copied every TG4Trajectory and TG4TrajectoryPoint on every event.  
+//       This test replaces the global operator new with one that counts calls, fills a TG4Event with a few of everything, 
+//       and then counts allocations while it looks at Primaries(), Trajectories(), and SegmentDetectors() over and over.  
+//       Returns non-zero if anything was allocated.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//app includes
+#include "app/Event.h"
+
+//c++ includes
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+  size_t gNAllocs = 0; //Number of times operator new has been called
+}
+
+void* operator new(std::size_t size)
+{
+  ++gNAllocs;
+  if(void* ptr = std::malloc(size?size:1)) return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+  ++gNAllocs;
+  if(void* ptr = std::malloc(size?size:1)) return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace app
+{
+  //Stands in for the real app::Worker, which is the only class allowed to fill a plgn::Event.  This test doesn't link 
+  //Worker.cpp.
+  class Worker
+  {
+    public:
+      static TG4Event& Fill(plgn::Event& event) { return **(event.Address()); }
+  };
+}
+
+//Look at everything in event like a plugin would.  Returns a number that depends on everything it looked at so that 
+//the compiler can't skip any of it.
+size_t ReadLikeAPlugin(const plgn::Event& event, const std::string& detName)
+{
+  size_t sum = event.RunId() + event.EventId();
+
+  const auto primaries = event.Primaries(); //Used to copy every TG4PrimaryVertex
+  for(const auto& vertex: primaries) sum += vertex.Particles.size();
+  if(!primaries.empty()) sum += primaries.front().Particles.size();
+
+  const auto trajs = event.Trajectories(); //Used to copy every TG4Trajectory
+  for(const auto& traj: trajs) sum += traj.Points.size();
+  for(size_t traj = 0; traj < trajs.size(); ++traj) sum += trajs[traj].Points.size();
+
+  for(const auto& det: event.SegmentDetectors())
+  {
+    sum += det.first.size();
+    for(const auto& seg: det.second) sum += (&seg - det.second.begin());
+  }
+  sum += event.SegmentDetectors()[detName].size();
+
+  return sum;
+}
+
+int main()
+{
+  plgn::Event event;
+  auto& tg4 = app::Worker::Fill(event);
+  tg4.RunId = 1;
+  tg4.EventId = 2;
+  tg4.Primaries.resize(2);
+  for(auto& vertex: tg4.Primaries) vertex.Particles.resize(3);
+  tg4.Trajectories.resize(50);
+  for(auto& traj: tg4.Trajectories) traj.Points.resize(10);
+  const std::string detName = "volA3DST_PV_with_a_name_too_long_for_small_strings"; //Made before counting starts
+  tg4.SegmentDetectors[detName].resize(100);
+  tg4.SegmentDetectors["volECal"].resize(20);
+
+  const size_t nEvents = 1000;
+  size_t sum = 0;
+  const size_t before = gNAllocs;
+  for(size_t entry = 0; entry < nEvents; ++entry) sum += ReadLikeAPlugin(event, detName);
+  const size_t nAllocs = gNAllocs - before;
+
+  if(nAllocs != 0)
+  {
+    std::cerr << "Reading a plgn::Event " << nEvents << " times allocated memory " << nAllocs << " times.  Plugins should never "
+              << "copy anything from the TG4Event.\n";
+    return 1;
+  }
+
+  std::cout << "Read a plgn::Event " << nEvents << " times with no allocations (checksum " << sum << ").\n";
+  return 0;
+}
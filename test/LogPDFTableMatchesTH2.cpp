@@ -0,0 +1,150 @@
+//File: LogPDFTableMatchesTH2.cpp
+//Brief: Makes sure that reco::LogPDFTable looks up the same bins as the TH2D it was made from.  CandFromPDF used to call
+//       std::log10(pdf.GetBinContent(pdf.FindBin(x, y))) for every cluster, so a LogPDFTable without interpolation has
+//       to give exactly that answer.  Builds a few small TH2Ds in memory with uniform axes, variable-width axes, an axis
+//       with only 1 bin, a uniform axis whose range doesn't divide evenly in floating point, and empty bins, then looks
+//       up every bin edge, the values right next to each edge, the under- and overflow bins, and random points.
+//
+//       With interpolation, a LogPDFTable has to match std::log10(pdf.Interpolate(x, y)) everywhere inside the
+//       histogram's range, including beyond the centers of the first and last bins.  TH2::Interpolate() refuses to
+//       work outside that range, so points there are only looked up without interpolation.  Returns non-zero if any
+//       point is different.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//reco includes
+#include "reco/alg/LogPDFTable.h"
+
+//ROOT includes
+#include "TH2D.h"
+#include "TAxis.h"
+
+//c++ includes
+#include <memory>
+#include <vector>
+#include <random>
+#include <string>
+#include <limits>
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+namespace
+{
+  //Fill every bin of pdf, including under- and overflow, with something different.  Some bins are empty so that
+  //their logarithms are -infinity.
+  void Fill(TH2D& pdf, std::mt19937& gen)
+  {
+    std::uniform_real_distribution<double> content(0., 1.);
+    for(int yBin = 0; yBin <= pdf.GetNbinsY()+1; ++yBin)
+    {
+      for(int xBin = 0; xBin <= pdf.GetNbinsX()+1; ++xBin)
+      {
+        const double value = content(gen);
+        pdf.SetBinContent(xBin, yBin, (value < 0.15)?0.:value);
+      }
+    }
+  }
+
+  //Every bin edge, the closest doubles on either side of it, the middle of each bin, and points beyond the ends of axis
+  std::vector<double> Special(const TAxis& axis)
+  {
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> points;
+    for(int bin = 1; bin <= axis.GetNbins()+1; ++bin)
+    {
+      const double edge = axis.GetBinLowEdge(bin);
+      points.push_back(edge);
+      points.push_back(std::nextafter(edge, -inf));
+      points.push_back(std::nextafter(edge, inf));
+      if(bin <= axis.GetNbins()) points.push_back(axis.GetBinCenter(bin));
+    }
+    const double width = axis.GetXmax() - axis.GetXmin();
+    points.push_back(axis.GetXmin() - width);
+    points.push_back(axis.GetXmax() + width);
+    points.push_back(axis.GetXmax() + 1e-3*width);
+    return points;
+  }
+
+  //Random points inside axis' range
+  std::vector<double> Random(const TAxis& axis, std::mt19937& gen)
+  {
+    std::uniform_real_distribution<double> pos(axis.GetXmin(), axis.GetXmax());
+    std::vector<double> points;
+    for(size_t point = 0; point < 50; ++point) points.push_back(pos(gen));
+    return points;
+  }
+
+  //Whether TH2::Interpolate() will work at x.  Round-off can put a point just below the end of a uniform axis in overflow.
+  bool Inside(const TAxis& axis, const double x)
+  {
+    const int bin = axis.FindFixBin(x);
+    return bin >= 1 && bin <= axis.GetNbins();
+  }
+
+  //Same logarithm, including -infinity for empty bins
+  bool Same(const double first, const double second)
+  {
+    if(std::isinf(first) || std::isinf(second)) return first == second;
+    return std::fabs(first - second) <= 1e-9*std::max(std::fabs(first), 1.);
+  }
+}
+
+int main()
+{
+  TH1::AddDirectory(false); //Nothing here belongs in a file
+  std::mt19937 gen(20200903);
+
+  const std::vector<double> xEdges = {0., 0.05, 0.1, 0.3, 0.35, 0.9, 1.}, yEdges = {1., 1.001, 1.5, 3., 10.};
+  std::vector<std::pair<std::string, std::unique_ptr<TH2D>>> pdfs;
+  pdfs.emplace_back("uniform axes", std::unique_ptr<TH2D>(new TH2D("uniform", "", 20, 0., 1., 10, 1., 2.)));
+  pdfs.emplace_back("uniform axes with round-off", std::unique_ptr<TH2D>(new TH2D("roundOff", "", 7, 0.1, 0.7, 3, -0.3, 0.6)));
+  pdfs.emplace_back("variable-width axes", std::unique_ptr<TH2D>(new TH2D("variable", "", xEdges.size()-1, xEdges.data(), yEdges.size()-1, yEdges.data())));
+  pdfs.emplace_back("variable-width x axis", std::unique_ptr<TH2D>(new TH2D("variableX", "", xEdges.size()-1, xEdges.data(), 4, 1., 10.)));
+  pdfs.emplace_back("1 bin on the y axis", std::unique_ptr<TH2D>(new TH2D("oneBin", "", 5, -1., 1., 1, 0., 3.)));
+
+  size_t nFailed = 0, nPoints = 0;
+  for(const auto& named: pdfs)
+  {
+    auto& pdf = *named.second;
+    Fill(pdf, gen);
+    const reco::LogPDFTable table(pdf, false), interpolated(pdf, true);
+
+    std::vector<double> xs = Special(*pdf.GetXaxis()), ys = Special(*pdf.GetYaxis());
+    const auto xRandom = Random(*pdf.GetXaxis(), gen), yRandom = Random(*pdf.GetYaxis(), gen);
+    xs.insert(xs.end(), xRandom.begin(), xRandom.end());
+    ys.insert(ys.end(), yRandom.begin(), yRandom.end());
+
+    for(const double x: xs)
+    {
+      for(const double y: ys)
+      {
+        ++nPoints;
+        const double expected = std::log10(pdf.GetBinContent(pdf.FindFixBin(x, y))), got = table(x, y);
+        if(!Same(got, expected))
+        {
+          ++nFailed;
+          std::cerr << "LogPDFTable found " << got << " at (" << x << ", " << y << ") in " << named.first << ", but the TH2D has "
+                    << expected << ".\n";
+        }
+
+        if(!Inside(*pdf.GetXaxis(), x) || !Inside(*pdf.GetYaxis(), y)) continue;
+        const double expectedInterp = std::log10(pdf.Interpolate(x, y)), gotInterp = interpolated(x, y);
+        if(!Same(gotInterp, expectedInterp))
+        {
+          ++nFailed;
+          std::cerr << "LogPDFTable interpolated " << gotInterp << " at (" << x << ", " << y << ") in " << named.first
+                    << ", but TH2::Interpolate() gives " << expectedInterp << ".\n";
+        }
+      }
+    }
+  }
+
+  if(nFailed > 0)
+  {
+    std::cerr << nFailed << " lookups out of " << nPoints << " points were different from the TH2Ds.\n";
+    return 1;
+  }
+
+  std::cout << "LogPDFTable matched the TH2Ds at all " << nPoints << " points.\n";
+  return 0;
+}
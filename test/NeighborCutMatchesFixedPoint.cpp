@@ -0,0 +1,234 @@
+//File: NeighborCutMatchesFixedPoint.cpp
+//Brief: Makes sure that reco::NeighborCut keeps exactly the same cubes as GridNeutronHits' old neighbor cut.  The old cut
+//       looked at every cube within NeighborCut of each candidate in a std::map, then moved candidates from a std::map of
+//       passed hits to a std::map of failed hits until nothing changed.  This test copies that code and runs both on a few
+//       hand-made voxel maps with the tricky cases, like a long chain of candidates that only touches a non-neutron hit at one
+//       end, and on voxel maps from fake events with tracks of neutron and non-neutron energy.  Returns non-zero if any voxel
+//       map gives different answers.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//edepsim includes
+#include "TG4HitSegment.h"
+
+//reco includes
+#include "reco/alg/GridHits.h"
+#include "reco/alg/NeighborCut.h"
+
+//c++ includes
+#include <map>
+#include <list>
+#include <vector>
+#include <random>
+#include <string>
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+namespace
+{
+  using Triple = reco::GridHits::Triple;
+  using HitData = reco::GridHits::HitData;
+  using Hits = std::map<Triple, HitData>;
+
+  const double eMin = 1.5; //Same as GridNeutronHits.yaml
+
+  //GridNeutronHits::Neighbors() before VoxelSums
+  bool OldNeighbors(const std::pair<Triple, HitData>& cand, const Hits& hits, const size_t nCubes, std::list<Triple>& neutronNeighbors)
+  {
+    bool noNeighbors = true;
+    auto key = cand.first;
+    for(int xOff = -(int)nCubes; xOff < (int)nCubes+1; ++xOff)
+    {
+      for(int yOff = -(int)nCubes; yOff < (int)nCubes+1; ++yOff)
+      {
+        for(int zOff = -(int)nCubes; zOff < (int)nCubes+1; ++zOff)
+        {
+          auto offPos = key;
+          offPos.First += xOff;
+          offPos.Second += yOff;
+          offPos.Third += zOff;
+          auto found = hits.find(offPos);
+          if(found != hits.end() && found->second.Energy > eMin)
+          {
+            if(found->second.Energy > 4.*found->second.OtherE) neutronNeighbors.push_back(offPos);
+            else noNeighbors = false;
+          }
+        }
+      }
+    }
+    return noNeighbors;
+  }
+
+  //GridNeutronHits::DoReconstruct() before union-find.  The old loop erased from failedHits while iterating over it.  This
+  //copy collects each round's new failures in a separate std::map instead, which reaches the same fixed point.
+  std::vector<Triple> OldCut(const Hits& hits, const size_t nCubes)
+  {
+    std::map<Triple, std::list<Triple>> passedHits, failedHits;
+    for(const auto& pair: hits)
+    {
+      const auto& hit = pair.second;
+      if(hit.Energy > eMin && hit.Energy > 4.*hit.OtherE)
+      {
+        std::list<Triple> neutronNeighbors;
+        if(OldNeighbors(pair, hits, nCubes, neutronNeighbors)) passedHits[pair.first] = neutronNeighbors;
+        else failedHits[pair.first] = neutronNeighbors;
+      }
+    }
+
+    size_t prevSize = passedHits.size()+1;
+    while(passedHits.size() < prevSize)
+    {
+      prevSize = passedHits.size();
+      std::map<Triple, std::list<Triple>> newlyFailed;
+      for(const auto& hit: failedHits)
+      {
+        for(const auto& pos: hit.second)
+        {
+          auto found = passedHits.find(pos);
+          if(found != passedHits.end())
+          {
+            newlyFailed[pos] = found->second;
+            passedHits.erase(found);
+          }
+        }
+      }
+      failedHits = std::move(newlyFailed);
+    }
+
+    std::vector<Triple> passed;
+    for(const auto& good: passedHits) passed.push_back(good.first);
+    return passed;
+  }
+
+  //How GridNeutronHits uses a NeighborCut now
+  std::vector<Triple> NewCut(reco::NeighborCut<Triple>& cut, const Hits& hits, const size_t nCubes)
+  {
+    cut.clear();
+    for(const auto& pair: hits)
+    {
+      const auto& hit = pair.second;
+      if(hit.Energy > eMin)
+      {
+        if(hit.Energy > 4.*hit.OtherE) cut.AddCandidate(pair.first);
+        else cut.AddOther(pair.first);
+      }
+    }
+    return cut.Passed(nCubes);
+  }
+
+  void AddCube(Hits& hits, const Triple& pos, const double energy, const double otherE)
+  {
+    auto& hit = hits[pos];
+    hit.Energy += energy;
+    hit.OtherE += otherE;
+  }
+
+  //Hand-made voxel maps for the cases the old loop was written for
+  std::vector<std::pair<std::string, Hits>> HandMade()
+  {
+    std::vector<std::pair<std::string, Hits>> maps;
+
+    Hits isolated;
+    AddCube(isolated, Triple(0, 0, 0), 3., 0.);
+    AddCube(isolated, Triple(10, 0, 0), 0., 0.); //Below threshold, so not a neighbor
+    maps.emplace_back("isolated candidate", isolated);
+
+    Hits chain;
+    for(int x = 0; x < 20; ++x) AddCube(chain, Triple(x, 0, 0), 3., 0.);
+    AddCube(chain, Triple(21, 0, 0), 3., 3.); //Only touches the last candidate
+    maps.emplace_back("long chain that touches a non-neutron hit at one end", chain);
+
+    Hits twoChains = chain;
+    for(int x = 0; x < 20; ++x) AddCube(twoChains, Triple(x, 5, 0), 3., 0.); //Too far from the first chain
+    maps.emplace_back("second chain that never touches anything", twoChains);
+
+    Hits bridge = twoChains;
+    AddCube(bridge, Triple(3, 2, 0), 3., 0.);
+    AddCube(bridge, Triple(3, 3, 0), 3., 0.);
+    maps.emplace_back("both chains joined by a bridge", bridge);
+
+    Hits dim;
+    for(int x = 0; x < 5; ++x) AddCube(dim, Triple(x, 0, 0), 3., 0.);
+    AddCube(dim, Triple(6, 0, 0), 1., 1.); //Non-neutron, but below threshold
+    AddCube(dim, Triple(-2, -1, -1), 2., 0.6); //Exactly 4x OtherE is not neutron-dominated
+    maps.emplace_back("non-neutron hits below threshold and at the 4x boundary", dim);
+
+    Hits corners;
+    AddCube(corners, Triple(-1, -1, -1), 3., 0.);
+    AddCube(corners, Triple(0, 0, 0), 3., 0.);
+    AddCube(corners, Triple(1, 1, 1), 3., 0.);
+    AddCube(corners, Triple(2, 2, 2), 3., 3.);
+    maps.emplace_back("diagonal chain with negative indices", corners);
+
+    return maps;
+  }
+
+  //Voxel maps from fake events: a few neutron-induced tracks and a few tracks from other particles near a vertex
+  Hits FakeEvent(std::mt19937& gen)
+  {
+    std::uniform_real_distribution<double> start(-30., 30.), dir(-1., 1.), energy(0., 5.), coin(0., 1.);
+    std::uniform_int_distribution<int> nTracks(1, 8), length(1, 40);
+
+    Hits hits;
+    const int nTrack = nTracks(gen);
+    for(int track = 0; track < nTrack; ++track)
+    {
+      const bool neutron = coin(gen) < 0.6;
+      double x = start(gen), y = start(gen), z = start(gen);
+      const double dx = dir(gen), dy = dir(gen), dz = dir(gen);
+      const int nSteps = length(gen);
+      for(int step = 0; step < nSteps; ++step)
+      {
+        const double edep = energy(gen);
+        AddCube(hits, Triple(std::lrint(x), std::lrint(y), std::lrint(z)), edep, neutron?0.:edep);
+        x += dx;
+        y += dy;
+        z += dz;
+      }
+    }
+    return hits;
+  }
+}
+
+int main()
+{
+  reco::NeighborCut<Triple> cut; //Reused between voxel maps like GridNeutronHits does
+  size_t nFailed = 0, nMaps = 0;
+
+  auto check = [&](const std::string& name, const Hits& hits, const size_t nCubes)
+  {
+    ++nMaps;
+    const auto expected = OldCut(hits, nCubes);
+    const auto& got = NewCut(cut, hits, nCubes);
+    if(got.size() == expected.size() && std::equal(got.begin(), got.end(), expected.begin(),
+                                                   [](const Triple& first, const Triple& second) { return !(first < second) && !(second < first); }))
+    {
+      return;
+    }
+
+    ++nFailed;
+    std::cerr << "NeighborCut kept " << got.size() << " cubes, but the old cut kept " << expected.size() << " cubes for "
+              << name << " with NeighborCut = " << nCubes << ".\n";
+  };
+
+  for(const auto& map: HandMade())
+  {
+    for(size_t nCubes = 1; nCubes <= 3; ++nCubes) check(map.first, map.second, nCubes);
+  }
+
+  std::mt19937 gen(20200731);
+  for(size_t event = 0; event < 200; ++event)
+  {
+    const auto hits = FakeEvent(gen);
+    for(size_t nCubes = 1; nCubes <= 3; ++nCubes) check("fake event " + std::to_string(event), hits, nCubes);
+  }
+
+  if(nFailed > 0)
+  {
+    std::cerr << nFailed << " of " << nMaps << " voxel maps gave different answers.\n";
+    return 1;
+  }
+
+  std::cout << "NeighborCut matched the old neighbor cut on all " << nMaps << " voxel maps.\n";
+  return 0;
+}
@@ -0,0 +1,246 @@
+//File: OctreeSegmentMatchesSampling.cpp
+//Brief: Makes sure that reco::Octree::Segment() shares a line segment between leaves the same way as chopping the segment
+//       into many tiny steps and looking up which leaf each step is in.  TreeNeutronHits shares each TG4HitSegment's energy
+//       by exit - enter, so every leaf's exit - enter has to match the fraction of steps in that leaf, and they have to add
+//       up to the fraction of the segment inside the whole box.  Also checks the cases that Clip() has to get right on
+//       purpose: segments that run along a boundary between leaves or along the box's faces, segments with no length
+//       inside and outside the box, and segments that are partly or entirely outside the box.  Returns non-zero if any
+//       segment is shared differently.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//reco includes
+#include "reco/alg/Octree.h"
+
+//c++ includes
+#include <map>
+#include <array>
+#include <vector>
+#include <random>
+#include <string>
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+namespace
+{
+  //Plain 3-vector so that Octree's KEY doesn't need ROOT
+  struct Vec
+  {
+    Vec(): fCoords{{0., 0., 0.}} {}
+    Vec(const double x, const double y, const double z): fCoords{{x, y, z}} {}
+
+    double operator [](const size_t axis) const { return fCoords[axis]; }
+
+    std::array<double, 3> fCoords;
+  };
+
+  using Leaf = std::array<int, 3>;
+  using Fractions = std::map<Leaf, double>;
+
+  //Box from -8 to 8 on every axis with 2 wide leaves.  Everything is a power of 2 so that boundaries are exact.
+  const double halfWidth = 8.;
+  const size_t depth = 3;
+  const int nLeaves = 1 << depth;
+  const double leafWidth = 2.*halfWidth/nLeaves;
+  const size_t nSteps = 20000;
+
+  //Leaf that pos is in along one axis.  A position on a boundary goes in the leaf above it like Octree::Descend(), and
+  //positions outside the box go in the nearest leaf.
+  int Index(const double pos)
+  {
+    return std::min(std::max((int)std::floor((pos + halfWidth)/leafWidth), 0), nLeaves-1);
+  }
+
+  Leaf LeafOf(const Vec& pos) { return Leaf{{Index(pos[0]), Index(pos[1]), Index(pos[2])}}; }
+
+  bool Inside(const Vec& pos)
+  {
+    for(size_t axis = 0; axis < 3; ++axis) if(std::fabs(pos[axis]) > halfWidth) return false;
+    return true;
+  }
+
+  Vec Along(const Vec& start, const Vec& stop, const double frac)
+  {
+    return Vec(start[0] + frac*(stop[0] - start[0]), start[1] + frac*(stop[1] - start[1]), start[2] + frac*(stop[2] - start[2]));
+  }
+
+  //Fraction of the segment in each leaf from the middle of each of nSteps steps
+  Fractions Sampled(const Vec& start, const Vec& stop)
+  {
+    Fractions fracs;
+    for(size_t step = 0; step < nSteps; ++step)
+    {
+      const auto pos = Along(start, stop, (step + 0.5)/nSteps);
+      if(Inside(pos)) fracs[LeafOf(pos)] += 1./nSteps;
+    }
+    return fracs;
+  }
+
+  //Fraction of the segment inside the box by clipping it against each pair of faces
+  double Clipped(const Vec& start, const Vec& stop)
+  {
+    double enter = 0., exit = 1.;
+    for(size_t axis = 0; axis < 3; ++axis)
+    {
+      const double dir = stop[axis] - start[axis];
+      if(dir == 0.)
+      {
+        if(std::fabs(start[axis]) > halfWidth) return 0.;
+        continue;
+      }
+      double first = (-halfWidth - start[axis])/dir, second = (halfWidth - start[axis])/dir;
+      if(first > second) std::swap(first, second);
+      enter = std::max(enter, first);
+      exit = std::min(exit, second);
+    }
+    return std::max(exit - enter, 0.);
+  }
+
+  struct Visit
+  {
+    Leaf leaf;
+    double enter;
+    double exit;
+  };
+
+  std::string Print(const Vec& pos)
+  {
+    return "(" + std::to_string(pos[0]) + ", " + std::to_string(pos[1]) + ", " + std::to_string(pos[2]) + ")";
+  }
+
+  //Hand-made segments for the cases Clip() has to handle on purpose
+  std::vector<std::pair<std::string, std::pair<Vec, Vec>>> HandMade()
+  {
+    std::vector<std::pair<std::string, std::pair<Vec, Vec>>> segs;
+
+    segs.emplace_back("diagonal through the center", std::make_pair(Vec(-7., -7., -7.), Vec(7., 7., 7.)));
+    segs.emplace_back("along a boundary between leaves", std::make_pair(Vec(2., -7.5, 0.3), Vec(2., 7.5, 0.3)));
+    segs.emplace_back("along an edge between 4 leaves", std::make_pair(Vec(-4., 0., -6.5), Vec(-4., 0., 6.5)));
+    segs.emplace_back("along the center of the box", std::make_pair(Vec(0., 0., -9.), Vec(0., 0., 9.)));
+    segs.emplace_back("along the box's +x face", std::make_pair(Vec(8., -3., 1.), Vec(8., 5., 1.)));
+    segs.emplace_back("along the box's -y face", std::make_pair(Vec(-3., -8., 1.), Vec(5., -8., -2.)));
+    segs.emplace_back("in a boundary plane", std::make_pair(Vec(-5., 6., 2.), Vec(7., -1., 2.)));
+    segs.emplace_back("ends on a boundary", std::make_pair(Vec(0.5, 0.5, 0.5), Vec(2., 1.5, 1.5)));
+    segs.emplace_back("through corners of leaves", std::make_pair(Vec(-6., -6., -6.), Vec(6., 6., 6.)));
+    segs.emplace_back("starts outside the box", std::make_pair(Vec(-12., 1., 1.), Vec(3., 2., 1.5)));
+    segs.emplace_back("stops outside the box", std::make_pair(Vec(3., 2., 1.5), Vec(5., 12., -11.)));
+    segs.emplace_back("passes through the box", std::make_pair(Vec(-10., -9., 11.), Vec(9., 10., -12.)));
+    segs.emplace_back("entirely outside the box", std::make_pair(Vec(9., 9., 9.), Vec(12., -12., 10.)));
+    segs.emplace_back("next to a face outside the box", std::make_pair(Vec(8.5, -5., 1.), Vec(8.5, 5., 1.)));
+    segs.emplace_back("no length inside the box", std::make_pair(Vec(1.5, -2.5, 3.), Vec(1.5, -2.5, 3.)));
+    segs.emplace_back("no length on a boundary", std::make_pair(Vec(2., 0., -4.), Vec(2., 0., -4.)));
+    segs.emplace_back("no length outside the box", std::make_pair(Vec(-10., 3., 20.), Vec(-10., 3., 20.)));
+
+    return segs;
+  }
+
+  //Segments with ends on a grid of quarter leaves, some of them outside the box, so that many of them run along
+  //boundaries or start on one
+  std::pair<Vec, Vec> FakeSegment(std::mt19937& gen)
+  {
+    std::uniform_int_distribution<int> grid(-48, 48), which(0, 3);
+    auto pos = [&gen, &grid]() { return Vec(grid(gen)/4., grid(gen)/4., grid(gen)/4.); };
+    const auto start = pos();
+    auto stop = pos();
+    const int flat = which(gen); //Keep one coordinate the same sometimes
+    if(flat < 3)
+    {
+      auto coords = stop.fCoords;
+      coords[flat] = start[flat];
+      stop = Vec(coords[0], coords[1], coords[2]);
+    }
+    return std::make_pair(start, stop);
+  }
+}
+
+int main()
+{
+  reco::Octree<int, Vec> tree(Vec(0., 0., 0.), Vec(halfWidth, halfWidth, halfWidth), depth); //Reused like TreeNeutronHits does
+  size_t nFailed = 0, nSegs = 0;
+  const double tolerance = 2./nSteps + 1e-9; //A leaf boundary can fall in the middle of at most one step on each side
+
+  std::vector<Visit> visits;
+  auto check = [&](const std::string& name, const Vec& start, const Vec& stop)
+  {
+    ++nSegs;
+    tree.clear();
+    visits.clear();
+    tree.Segment(start, stop, [&visits](const Vec& center, int& cell, const double enter, const double exit)
+                              {
+                                ++cell;
+                                visits.push_back(Visit{LeafOf(center), enter, exit});
+                              });
+
+    std::string problem;
+    Fractions got;
+    double total = 0.;
+    for(const auto& visit: visits)
+    {
+      if(!(visit.enter >= 0. && visit.exit <= 1. && visit.exit >= visit.enter)) problem += " Visited a leaf from " + std::to_string(visit.enter)
+                                                                                           + " to " + std::to_string(visit.exit) + ".";
+      if(got.count(visit.leaf)) problem += " Visited the same leaf twice.";
+      got[visit.leaf] = visit.exit - visit.enter;
+      total += visit.exit - visit.enter;
+    }
+
+    const bool point = (start[0] == stop[0] && start[1] == stop[1] && start[2] == stop[2]);
+    if(point)
+    {
+      //A segment with no length is entirely in the leaf start is in, even outside the box
+      if(visits.size() != 1 || visits.front().leaf != LeafOf(start) || visits.front().enter != 0. || visits.front().exit != 1.)
+      {
+        problem += " Did not put a segment with no length entirely in the leaf it's in.";
+      }
+    }
+    else
+    {
+      const double clipped = Clipped(start, stop);
+      if(std::fabs(total - clipped) > 1e-12) problem += " Leaves add up to " + std::to_string(total) + " of the segment, but "
+                                                        + std::to_string(clipped) + " of it is inside the box.";
+
+      const auto expected = Sampled(start, stop);
+      for(const auto& leaf: expected)
+      {
+        const auto found = got.find(leaf.first);
+        const double frac = (found == got.end())?0.:found->second;
+        if(std::fabs(frac - leaf.second) > tolerance) problem += " A leaf got " + std::to_string(frac) + " of the segment instead of "
+                                                                 + std::to_string(leaf.second) + ".";
+      }
+      for(const auto& leaf: got)
+      {
+        if(!expected.count(leaf.first) && leaf.second > tolerance) problem += " A leaf that no step is in got " + std::to_string(leaf.second)
+                                                                              + " of the segment.";
+      }
+    }
+
+    if(tree.size() != visits.size()) problem += " Made " + std::to_string(tree.size()) + " leaves but visited " + std::to_string(visits.size()) + ".";
+
+    if(!problem.empty())
+    {
+      ++nFailed;
+      std::cerr << "Segment from " << Print(start) << " to " << Print(stop) << ", " << name << ":" << problem << "\n";
+    }
+  };
+
+  for(const auto& seg: HandMade())
+  {
+    check(seg.first, seg.second.first, seg.second.second);
+    check(seg.first + " backwards", seg.second.second, seg.second.first);
+  }
+
+  std::mt19937 gen(20200824);
+  for(size_t seg = 0; seg < 2000; ++seg)
+  {
+    const auto ends = FakeSegment(gen);
+    check("fake segment " + std::to_string(seg), ends.first, ends.second);
+  }
+
+  if(nFailed > 0)
+  {
+    std::cerr << nFailed << " of " << nSegs << " segments were shared between leaves differently from sampling.\n";
+    return 1;
+  }
+
+  std::cout << "Octree::Segment() matched sampling on all " << nSegs << " segments.\n";
+  return 0;
+}
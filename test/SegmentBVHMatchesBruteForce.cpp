@@ -0,0 +1,206 @@
+//File: SegmentBVHMatchesBruteForce.cpp
+//Brief: Makes sure that reco::SegmentBVH::Overlaps() visits exactly the segments whose bounding boxes overlap a query
+//       box, each of them once, by checking every segment one at a time.  Also checks that no segment that actually
+//       passes through the box is left out.  NoGridNeutronHits uses Overlaps() to find the TG4HitSegments near each
+//       hit, so a missing segment would lose energy.  Events have segments with no length, segments that all have the
+//       same center, query boxes that just touch a segment's bounding box, and enough segments for a deep tree.  The
+//       same SegmentBVH is clear()ed and reused between events like NoGridNeutronHits does.  Returns non-zero if any
+//       query visits different segments.
+//Author: Andrew Olivier aolivier@ur.rochester.edu
+
+//reco includes
+#include "reco/alg/SegmentBVH.h"
+
+//ROOT includes
+#include "TVector3.h"
+
+//c++ includes
+#include <vector>
+#include <random>
+#include <string>
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+namespace
+{
+  struct Seg
+  {
+    TVector3 start;
+    TVector3 stop;
+  };
+
+  //Does seg's bounding box overlap the box from low to high?  Touching counts.
+  bool BoxesOverlap(const Seg& seg, const TVector3& low, const TVector3& high)
+  {
+    for(size_t axis = 0; axis < 3; ++axis)
+    {
+      if(std::max(seg.start[axis], seg.stop[axis]) < low[axis] || std::min(seg.start[axis], seg.stop[axis]) > high[axis]) return false;
+    }
+    return true;
+  }
+
+  //Does seg itself pass through the box from low to high?  Clips it against each pair of faces.
+  bool Crosses(const Seg& seg, const TVector3& low, const TVector3& high)
+  {
+    double enter = 0., exit = 1.;
+    for(size_t axis = 0; axis < 3; ++axis)
+    {
+      const double dir = seg.stop[axis] - seg.start[axis];
+      if(dir == 0.)
+      {
+        if(seg.start[axis] < low[axis] || seg.start[axis] > high[axis]) return false;
+        continue;
+      }
+      double first = (low[axis] - seg.start[axis])/dir, second = (high[axis] - seg.start[axis])/dir;
+      if(first > second) std::swap(first, second);
+      enter = std::max(enter, first);
+      exit = std::min(exit, second);
+    }
+    return exit >= enter;
+  }
+
+  //1 cm steps in random directions like TG4HitSegments on a track, with some tracks that stop in place
+  std::vector<Seg> FakeEvent(std::mt19937& gen, const size_t nTracks)
+  {
+    std::uniform_real_distribution<double> start(-100., 100.), dir(-1., 1.), coin(0., 1.);
+    std::uniform_int_distribution<int> length(1, 60);
+
+    std::vector<Seg> segs;
+    for(size_t track = 0; track < nTracks; ++track)
+    {
+      TVector3 pos(start(gen), start(gen), start(gen));
+      const TVector3 step(10.*dir(gen), 10.*dir(gen), 10.*dir(gen));
+      const bool stuck = coin(gen) < 0.1;
+      const int nSteps = length(gen);
+      for(int seg = 0; seg < nSteps; ++seg)
+      {
+        const TVector3 next = stuck?pos:TVector3(pos[0] + step[0], pos[1] + step[1], pos[2] + step[2]);
+        segs.push_back(Seg{pos, next});
+        pos = next;
+      }
+    }
+    return segs;
+  }
+
+  //Hand-made events for the cases that are easy to get wrong
+  std::vector<std::pair<std::string, std::vector<Seg>>> HandMade()
+  {
+    std::vector<std::pair<std::string, std::vector<Seg>>> events;
+
+    events.emplace_back("no segments", std::vector<Seg>());
+    events.emplace_back("one segment", std::vector<Seg>{Seg{TVector3(0., 0., 0.), TVector3(10., 5., -5.)}});
+
+    std::vector<Seg> sameCenter;
+    for(int seg = 0; seg < 50; ++seg) sameCenter.push_back(Seg{TVector3(-seg, 0., seg), TVector3(seg, 0., -seg)});
+    events.emplace_back("segments with the same center", sameCenter);
+
+    std::vector<Seg> points;
+    for(int seg = 0; seg < 30; ++seg) points.push_back(Seg{TVector3(seg, 2.*seg, 0.), TVector3(seg, 2.*seg, 0.)});
+    events.emplace_back("segments with no length", points);
+
+    std::vector<Seg> grid; //Bounding boxes on a grid, so query boxes on the same grid touch them exactly
+    for(int x = 0; x < 10; ++x)
+    {
+      for(int y = 0; y < 10; ++y) grid.push_back(Seg{TVector3(10.*x, 10.*y, 0.), TVector3(10.*x + 10., 10.*y + 10., 10.)});
+    }
+    events.emplace_back("segments on a grid", grid);
+
+    return events;
+  }
+}
+
+int main()
+{
+  reco::SegmentBVH bvh; //Reused between events like NoGridNeutronHits does
+  size_t nFailed = 0, nQueries = 0;
+  std::mt19937 gen(20200817);
+  std::uniform_real_distribution<double> corner(-120., 120.), width(0., 40.);
+  std::uniform_int_distribution<int> gridCorner(-1, 10), gridWidth(0, 3);
+
+  std::vector<size_t> visited;
+  auto check = [&](const std::string& name, const std::vector<Seg>& segs, const TVector3& low, const TVector3& high)
+  {
+    ++nQueries;
+    visited.clear();
+    bvh.Overlaps(low, high, [&visited](const size_t index) { visited.push_back(index); });
+    std::sort(visited.begin(), visited.end());
+
+    std::vector<size_t> expected;
+    for(size_t seg = 0; seg < segs.size(); ++seg) if(BoxesOverlap(segs[seg], low, high)) expected.push_back(seg);
+
+    std::string problem;
+    if(visited != expected) problem += " Visited " + std::to_string(visited.size()) + " segments, but " + std::to_string(expected.size())
+                                       + " bounding boxes overlap the query box.";
+    for(size_t seg = 0; seg < segs.size(); ++seg)
+    {
+      if(Crosses(segs[seg], low, high) && !std::binary_search(visited.begin(), visited.end(), seg))
+      {
+        problem += " Left out segment " + std::to_string(seg) + " that passes through the query box.";
+      }
+    }
+
+    if(!problem.empty())
+    {
+      ++nFailed;
+      std::cerr << name << ", query box from (" << low[0] << ", " << low[1] << ", " << low[2] << ") to (" << high[0] << ", "
+                << high[1] << ", " << high[2] << "):" << problem << "\n";
+    }
+  };
+
+  auto fill = [&bvh](const std::vector<Seg>& segs)
+  {
+    bvh.clear();
+    for(size_t seg = 0; seg < segs.size(); ++seg) bvh.insert(seg, segs[seg].start, segs[seg].stop);
+    bvh.Build();
+  };
+
+  for(const auto& event: HandMade())
+  {
+    fill(event.second);
+    if(bvh.size() != event.second.size())
+    {
+      ++nFailed;
+      std::cerr << "SegmentBVH has " << bvh.size() << " segments after inserting " << event.second.size() << " for " << event.first << ".\n";
+    }
+
+    for(size_t query = 0; query < 200; ++query)
+    {
+      const TVector3 low(10.*gridCorner(gen), 10.*gridCorner(gen), 10.*gridCorner(gen)); //Faces exactly on the grid
+      const TVector3 high(low[0] + 10.*gridWidth(gen), low[1] + 10.*gridWidth(gen), low[2] + 10.*gridWidth(gen));
+      check(event.first, event.second, low, high);
+    }
+  }
+
+  for(size_t event = 0; event < 20; ++event)
+  {
+    const auto segs = FakeEvent(gen, (event % 2)?200:5);
+    fill(segs);
+    for(size_t query = 0; query < 200; ++query)
+    {
+      const TVector3 low(corner(gen), corner(gen), corner(gen));
+      const TVector3 high(low[0] + width(gen), low[1] + width(gen), low[2] + width(gen));
+      check("fake event " + std::to_string(event), segs, low, high);
+    }
+
+    //Query boxes that are exactly a segment's bounding box touch at least that segment
+    for(size_t seg = 0; seg < segs.size(); seg += 7)
+    {
+      const TVector3 low(std::min(segs[seg].start[0], segs[seg].stop[0]), std::min(segs[seg].start[1], segs[seg].stop[1]),
+                         std::min(segs[seg].start[2], segs[seg].stop[2]));
+      const TVector3 high(std::max(segs[seg].start[0], segs[seg].stop[0]), std::max(segs[seg].start[1], segs[seg].stop[1]),
+                          std::max(segs[seg].start[2], segs[seg].stop[2]));
+      check("fake event " + std::to_string(event) + " around a segment", segs, low, high);
+      check("fake event " + std::to_string(event) + " at a corner", segs, high, high);
+    }
+  }
+
+  if(nFailed > 0)
+  {
+    std::cerr << nFailed << " of " << nQueries << " queries visited different segments than checking every segment.\n";
+    return 1;
+  }
+
+  std::cout << "SegmentBVH::Overlaps() matched checking every segment on all " << nQueries << " queries.\n";
+  return 0;
+}